@@ -59,3 +59,10 @@ common:
 	# when parsing the file system looking for libraries exclude this for all or
 	# a specific platform
 	# ADDON_LIBS_EXCLUDE =
+
+linux64:
+	# shm_open() for ofxControllerStatePublisher on older glibc
+	ADDON_LDFLAGS = -lrt
+
+linux:
+	ADDON_LDFLAGS = -lrt
@@ -3,15 +3,127 @@
 #include "ofEvent.h"
 
 #include <cmath>
-#include <unordered_set>
+#include <cstring>
+#include <thread>
+
+namespace {
+// Fractional MIDI position of a value in a monotonic lookup table, clamped
+// to the table ends, so values outside min/max still pickup at endpoints.
+float lutPosition(const float * lut, float value){
+    const int last = ofxControllerCurve::tableSize - 1;
+    bool rising = lut[last] >= lut[0];
+    if(rising ? value <= lut[0] : value >= lut[0]) return 0.0f;
+    if(rising ? value >= lut[last] : value <= lut[last]) return (float)last;
+
+    int lo = 0;
+    int hi = last;
+    while(hi - lo > 1){
+        int mid = (lo + hi) / 2;
+        if(rising ? lut[mid] <= value : lut[mid] >= value){
+            lo = mid;
+        }else{
+            hi = mid;
+        }
+    }
+    float span = lut[hi] - lut[lo];
+    return lo + (span != 0.0f ? (value - lut[lo]) / span : 0.0f);
+}
+
+// Value of a lookup table at a fractional MIDI position.
+float lutValue(const float * lut, float position){
+    const int last = ofxControllerCurve::tableSize - 1;
+    if(position <= 0.0f) return lut[0];
+    if(position >= last) return lut[last];
+    int i = (int)position;
+    float frac = position - i;
+    return lut[i] + (lut[i + 1] - lut[i]) * frac;
+}
+
+// InputType flag of a status byte, 0 for system messages.
+int inputTypeOf(int status){
+    switch(status){
+     case MIDI_NOTE_ON:
+     case MIDI_NOTE_OFF:         return ofxControllerBase::LC_INPUT_NOTES;
+     case MIDI_CONTROL_CHANGE:   return ofxControllerBase::LC_INPUT_CC;
+     case MIDI_PROGRAM_CHANGE:   return ofxControllerBase::LC_INPUT_PROGRAM;
+     case MIDI_PITCH_BEND:       return ofxControllerBase::LC_INPUT_PITCHBEND;
+     case MIDI_AFTERTOUCH:
+     case MIDI_POLY_AFTERTOUCH:  return ofxControllerBase::LC_INPUT_AFTERTOUCH;
+     default:                    return 0;
+    }
+}
+
+// Signed step count of a relative encoder message.
+int encoderDelta(int midi, ofxControllerBase::EncoderMode mode){
+    switch(mode){
+     case ofxControllerBase::LC_ENCODER_TWOS_COMPLEMENT: return midi < 64 ? midi : midi - 128;
+     case ofxControllerBase::LC_ENCODER_SIGN_BIT:        return (midi & 0x40) ? -(midi & 0x3F) : midi;
+     case ofxControllerBase::LC_ENCODER_OFFSET_64:
+     default:                                            return midi - 64;
+    }
+}
+
+// Acceleration factor from the time between two encoder messages.
+float encoderVelocity(uint64_t interval, float acceleration){
+    const uint64_t fast = 5000000;   // 5 ms, full acceleration
+    const uint64_t slow = 100000000; // 100 ms, no acceleration
+    if(acceleration <= 1.0f || interval >= slow){
+        return 1.0f;
+    }
+    float t = interval <= fast ? 1.0f : float(slow - interval) / float(slow - fast);
+    return 1.0f + (acceleration - 1.0f) * t * t;
+}
+
+// Assigns only when the value changes, so unchanged values don't notify
+// the parameter listeners (guis, presets, app callbacks) again.
+template <typename T>
+void writeIfChanged(ofParameter <T> & param, const T & value){
+    if(param.get() != value){
+        param = value;
+    }
+}
+}
 
 ofxControllerBase::ofxControllerBase(){
 	name = "launch control";
 
     buffer.resize(4096);
+    bufferTimes.resize(buffer.size(), 0);
     written = 0;
     lastRead = written;
     buttonLedsEnabled = true;
+    channelMask = 0xFFFF;
+    inputTypes = LC_INPUT_NOTES | LC_INPUT_CC;
+    bWritingKnobs = false;
+    numLeds = 0;
+    bReconnectRunning = false;
+    reconnectInterval = 1000;
+    bConnected = false;
+    bReconnected = false;
+    bLedsDirty = false;
+    bRefreshLeds = false;
+    bQueueLeds = false;
+    manager = nullptr;
+    std::fill(ledQueued, ledQueued + 128, -1);
+
+    active = nullptr;
+    activePage = 0;
+    editedPage = 0;
+    basePage = 0;
+    heldModifier = -1;
+    bStagedChanged = false;
+
+    std::memset(&state, 0, sizeof(state));
+    bStateChanged = false;
+
+    numMidiCallbacks = 0;
+    midiCallbacksBound = false;
+
+    subscribers.reset(new EventSubscriber[maxSubscribers]);
+    numSubscribers = 0;
+    longPressTime = 500000000; // 0.5 s
+    doubleTapTime = 300000000;
+    repeatTime = 100000000;
 }
 
 ofxControllerBase::~ofxControllerBase(){
@@ -24,181 +136,549 @@ void ofxControllerBase::listDevices(){
 
 
 bool ofxControllerBase::setup(int port, int channel){
+    // the name lets the reconnect thread find the device again, also when
+    // the port can't be opened now
+    std::string portName;
+    auto ports = midiIn.getInPortList();
+    if(port >= 0 && port < (int)ports.size()){
+        portName = ports[port];
+    }
+    return setupPorts(port, portName, channel);
+}
+
+bool ofxControllerBase::setup(const std::string & portName, int channel){
+    return setupPorts(-1, portName, channel);
+}
+
+bool ofxControllerBase::setupPorts(int port, const std::string & portName, int channel){
+    disableReconnect(); // enableReconnect() again after setup()
 
     this->channel = channel;
     buttonsColor = ofxLCLeds::Red;
+    if(channel >= 1 && channel <= 16){
+        channelMask = 1 << (channel - 1);
+    }else{
+        channelMask = 0xFFFF;
+    }
+
+    if(pages.empty()){
+        std::lock_guard <std::recursive_mutex> lock(bindingMutex);
+        pages.push_back(makePage("default"));
+        staged.push_back(makePage("default"));
+        stagedChanged.assign(1, 0);
+        active = pages[0].get();
+        activePage = editedPage = basePage = 0;
+    }
+    pageForButton.assign(buttonsNote.size(), -1);
+    immediates.resize(knobsCC.size());
+
+    knobIndexForCC.assign(128, -1);
+    for(size_t i = 0; i < knobsCC.size(); ++i){
+        if(knobsCC[i] >= 0 && knobsCC[i] < 128){
+            knobIndexForCC[knobsCC[i]] = i;
+        }
+    }
 
-    knobs.resize(knobsCC.size());
+    buttonIndexForNote.assign(128, -1);
+    for(size_t b = 0; b < buttonsNote.size(); ++b){
+        if(buttonsNote[b] >= 0 && buttonsNote[b] < 128){
+            buttonIndexForNote[buttonsNote[b]] = b;
+        }
+    }
+
+    if(knobTimes.size() != knobsCC.size()){
+        knobTimes = std::vector <std::atomic <uint64_t> >(knobsCC.size());
+    }
+    if(buttonTimes.size() != buttonsNote.size()){
+        buttonTimes = std::vector <std::atomic <uint64_t> >(buttonsNote.size());
+    }
+    for(auto & t : knobTimes){ t = 0; }
+    for(auto & t : buttonTimes){ t = 0; }
 
-    radios.clear();
-    midiIn.openPort(port);
+    if(numLeds != buttonsNote.size()){
+        numLeds = buttonsNote.size();
+        ledDirty.reset(new std::atomic <bool> [numLeds]);
+    }
+    for(size_t b = 0; b < numLeds; ++b){
+        ledDirty[b] = false;
+    }
+    bLedsDirty = false;
+    bRefreshLeds = false;
+
+    inPortName.clear();
+    outPortName.clear();
+    bConnected = false;
+    if(port >= 0){
+        midiIn.openPort(port);
+    }else if(!portName.empty()){
+        midiIn.openPort(portName);
+    }
 
     if(midiIn.isOpen()){
+      midiIn.removeListener(this); // once, also when set up again
       midiIn.addListener(this);
-      leds.openPort(port);
+      if(port >= 0){
+          leds.openPort(port);
+      }else{
+          leds.openPort(portName);
+      }
+      inPortName = midiIn.getName();
+      outPortName = leds.isOpen() ? leds.getName() : "";
+      bConnected = true;
       ofLogNotice() << "ofxLaunchControls: " << name << " activated!";
+    }else if(!portName.empty()){
+      // bindable, the reconnect thread opens the ports when the device appears
+      midiIn.removeListener(this);
+      midiIn.addListener(this);
+      inPortName = portName;
+      outPortName = portName; // usually the same name both ways
+      ofLogWarning() << "ofxLaunchControls: " << name << " not connected, waiting for " << portName;
+    }
+
+    size_t sources = buttonsNote.size() + 128;
+    if(numMidiCallbacks != sources * 2){
+        numMidiCallbacks = sources * 2;
+        midiCallbacks.reset(new MidiCallbackSlot[numMidiCallbacks]);
     }
+    midiHeld.assign(sources, 0);
+    gestures.assign(sources, LC_GESTURE_IDLE);
+    gestureTimers.setup(sources, ofxControllerClock::now());
+    pendingCallbacks.clear();
+    pendingCallbacks.reserve(256);
 
     bEasing = false;
     easeAmount = 0.05f;
+    encoderScale = 1.0f;
+    std::fill(nrpnNumber, nrpnNumber + 16, -1);
+    std::fill(nrpnMsb, nrpnMsb + 16, 0);
 
     bUpdate = false;
 
     clearLeds();
 
-    int prio = 0; // OF_EVENT_PRIORITY_BEFORE_APP
-    ofAddListener(ofEvents().update, this, &ofxControllerBase::update, prio);
+    ledQueue.clear();
+    ledQueue.reserve(128);
+    std::fill(ledQueued, ledQueued + 128, -1);
+
+    // a manager updates the controllers it owns
+    if(!manager){
+        int prio = 0; // OF_EVENT_PRIORITY_BEFORE_APP
+        ofAddListener(ofEvents().update, this, &ofxControllerBase::update, prio);
+    }
   
   return true;
 }
 
 
 void ofxControllerBase::update(ofEventArgs & events){
+    uint64_t start = ofxControllerClock::now();
+    drain(start);
+    flush();
+    sendLeds();
+    stats.addUpdate(ofxControllerClock::now() - start);
+}
+
+void ofxControllerBase::drain(uint64_t now){
+    bQueueLeds = true; // until the end of flush()
+
+    if(bReconnected){
+        resyncReconnected();
+    }
+
+    if(bStagedChanged){
+        publishBindings();
+    }
+
     int read = written;
 
     while(lastRead != read){
-        processMessage(buffer[lastRead]);
+        uint64_t time = bufferTimes[lastRead];
+        processMessage(buffer[lastRead], time);
+        stats.addLatency(now > time ? now - time : 0);
         lastRead++;
         if(lastRead >= int(buffer.size())){
             lastRead = 0;
         }
     }
 
+    if(gestureTimers.getNumPending() > 0){
+        gestureTimers.advance(now, [this, now](size_t source){
+            gestureTimeout(source, now);
+        });
+    }
+}
+
+void ofxControllerBase::flush(){
     if(bUpdate){
 		bUpdate = false;
-        // buttons update
-        for(size_t b = 0; b < buttons.size(); ++b){
-            if(buttons[b].bUpdate){
-                switch(buttons[b].typeCode){
-                 case 1:    // bool
-                     *(buttons[b].pParamb) = buttons[b].bActive;
-                     break;
+        writeBindings(*active);
+        bStateChanged = true;
+    }
 
-                 case 2:    // float
-                     if(buttons[b].bActive){
-                         *(buttons[b].pParamf) = buttons[b].maxf;
-                     }else{
-                         *(buttons[b].pParamf) = buttons[b].minf;
-                     }
-                     break;
+    // update leds, the writes above marked the ones they changed
+    if(buttonLedsEnabled){
+        if(bRefreshLeds){
+            refreshLeds();
+        }else if(bLedsDirty){
+            flushLeds();
+        }
+    }
 
-                 case 3:    // int
-                     if(buttons[b].bActive){
-                         *(buttons[b].pParami) = buttons[b].maxi;
-                     }else{
-                         *(buttons[b].pParami) = buttons[b].mini;
-                     }
-                     break;
-                }
-                buttons[b].bUpdate = false;
+    if(!pendingCallbacks.empty()){
+        runCallbacks();
+    }
+
+    if(bStateChanged){
+        publishState();
+    }
+
+    onUpdate();
+    bQueueLeds = false;
+}
+
+void ofxControllerBase::sendLed(int note, int color){
+    if(note < 0 || note > 127){
+        return;
+    }
+    if(!bQueueLeds){
+        auto ports = tryLockPorts();
+        if(ports.owns_lock()){
+            leds.sendNoteOn(channel, note, color);
+            stats.ledMessages++;
+            return;
+        }
+        // being reconnected, the next update sends it
+    }
+    if(ledQueued[note] >= 0){
+        ledQueue[ledQueued[note]].second = color;
+        stats.ledsCoalesced++;
+    }else{
+        ledQueued[note] = ledQueue.size();
+        ledQueue.emplace_back(note, color);
+    }
+}
+
+void ofxControllerBase::sendLeds(){
+    auto ports = tryLockPorts();
+    if(!ports.owns_lock()){
+        return; // being reconnected, the queue keeps one message per note
+    }
+    for(auto & led : ledQueue){
+        leds.sendNoteOn(channel, led.first, led.second);
+        ledQueued[led.first] = -1;
+    }
+    stats.ledMessages += ledQueue.size();
+    ledQueue.clear();
+}
+
+std::unique_lock <std::recursive_mutex> ofxControllerBase::tryLockPorts(){
+    return std::unique_lock <std::recursive_mutex>(portMutex, std::try_to_lock);
+}
+
+void ofxControllerBase::enableReconnect(float intervalSeconds){
+    disableReconnect();
+    if(!isBindable()){
+        ofLogError() << "ofxLaunchControls: enableReconnect() needs setup() with a port, ignored";
+        return;
+    }
+    reconnectInterval = intervalSeconds > 0.01f ? uint64_t(intervalSeconds * 1000.0f) : 10;
+    bReconnectRunning = true;
+    reconnectThread = std::thread(&ofxControllerBase::watchPorts, this);
+}
+
+void ofxControllerBase::disableReconnect(){
+    {
+        std::lock_guard <std::mutex> lock(reconnectMutex);
+        bReconnectRunning = false;
+    }
+    reconnectCondition.notify_all();
+    if(reconnectThread.joinable()){
+        reconnectThread.join();
+    }
+}
+
+bool ofxControllerBase::isConnected() const {
+    return bConnected;
+}
+
+void ofxControllerBase::watchPorts(){
+    ofxMidiIn probe; // port list only, never opened
+
+    std::unique_lock <std::mutex> lock(reconnectMutex);
+    while(bReconnectRunning){
+        reconnectCondition.wait_for(lock, std::chrono::milliseconds(reconnectInterval));
+        if(!bReconnectRunning){
+            break;
+        }
+        lock.unlock();
+
+        auto available = probe.getInPortList();
+        bool present = std::find(available.begin(), available.end(), inPortName) != available.end();
+
+        if(bConnected && !present){
+            std::lock_guard <std::recursive_mutex> ports(portMutex);
+            midiIn.closePort();
+            leds.closePort();
+            bConnected = false;
+            onDisconnect();
+            ofLogWarning() << "ofxLaunchControls: " << name << " disconnected";
+        }else if(!bConnected && present){
+            std::lock_guard <std::recursive_mutex> ports(portMutex);
+            // by name, the port numbers change when devices come and go
+            midiIn.openPort(inPortName);
+            if(!outPortName.empty()){
+                leds.openPort(outPortName);
+            }
+            if(midiIn.isOpen() && onReconnect()){
+                bConnected = true;
+                bReconnected = true;
+                ofLogNotice() << "ofxLaunchControls: " << name << " reconnected";
+            }else{
+                midiIn.closePort();
+                leds.closePort();
             }
         }
 
-        // cc "toggle buttons" update
-        for(size_t b = 0; b < ccButtons.size(); ++b){
-            if(ccButtons[b].bUpdate){
-                if(ccButtons[b].typeCode == LC_TYPECODE_BOOL && ccButtons[b].pParamb){
-                    *(ccButtons[b].pParamb) = ccButtons[b].bActive;
-                }
-                ccButtons[b].bUpdate = false;
+        lock.lock();
+    }
+}
+
+void ofxControllerBase::resyncReconnected(){
+    bReconnected = false;
+
+    // the controls may have moved while unplugged, their positions are unknown
+    for(auto & t : knobTimes){
+        t = 0;
+    }
+    if(active){
+        resyncKnobs(*active);
+    }
+    gestures.assign(gestures.size(), LC_GESTURE_IDLE);
+    gestureTimers.cancelAll();
+
+    // the device starts dark, the parameters are the shadow state
+    bRefreshLeds = true;
+    bStateChanged = true;
+    onReconnected();
+}
+
+void ofxControllerBase::resetStats(){
+    stats = ofxControllerStats();
+}
+
+void ofxControllerBase::writeBindings(BindingSet & page){
+    auto & buttons = page.buttons;
+    auto & ccButtons = page.ccButtons;
+    auto & radios = page.radios;
+    auto & knobs = page.knobs;
+
+    // buttons update
+    for(size_t b = 0; b < buttons.size(); ++b){
+        if(buttons[b].bUpdate){
+            switch(buttons[b].typeCode){
+             case 1:    // bool
+                 writeIfChanged(*(buttons[b].pParamb), buttons[b].bActive.load());
+                 break;
+
+             case 2:    // float
+                 if(buttons[b].bActive){
+                     writeIfChanged(*(buttons[b].pParamf), buttons[b].maxf);
+                 }else{
+                     writeIfChanged(*(buttons[b].pParamf), buttons[b].minf);
+                 }
+                 break;
+
+             case 3:    // int
+                 if(buttons[b].bActive){
+                     writeIfChanged(*(buttons[b].pParami), buttons[b].maxi);
+                 }else{
+                     writeIfChanged(*(buttons[b].pParami), buttons[b].mini);
+                 }
+                 break;
             }
+            buttons[b].bUpdate = false;
         }
+    }
 
-        // radio buttons update
-        for(size_t i = 0; i < radios.size(); ++i){
-            if(radios[i].bUpdate){
-                *(radios[i].pParami) = radios[i].value;
-                radios[i].bUpdate = false;
+    // cc "toggle buttons" update
+    for(size_t b = 0; b < ccButtons.size(); ++b){
+        if(ccButtons[b].bUpdate){
+            if(ccButtons[b].typeCode == LC_TYPECODE_BOOL && ccButtons[b].pParamb){
+                writeIfChanged(*(ccButtons[b].pParamb), ccButtons[b].bActive.load());
             }
+            ccButtons[b].bUpdate = false;
         }
+    }
 
-		static const float stopvalue = 0.00001f;
-
-        // knob update
-        for(size_t i = 0; i < knobs.size(); ++i){
-            for(size_t k = 0; k < knobs[i].size(); k++){
-                if(knobs[i][k].bUpdate){
-                    switch(knobs[i][k].typeCode){
-                     case LC_TYPECODE_FLOAT:
-                         if(bEasing){
-                             // lpf code
-                             float xn = (knobs[i][k].value * easeAmount + knobs[i][k].z1 * (1.0f - easeAmount));
-                             knobs[i][k].z1 = xn;
-                             if(abs(knobs[i][k].value - knobs[i][k].z1) < stopvalue){
-                                 knobs[i][k].z1 = knobs[i][k].value;
-                                 knobs[i][k].bUpdate = false;
-                             }else{
-                                 bUpdate = true;    // keeps global update alive
-                             }
-                             *(knobs[i][k].pParamf) = knobs[i][k].z1;
-                         }else{
-                             // just set value
-                             *(knobs[i][k].pParamf) = knobs[i][k].value;
+    // radio buttons update
+    for(int i = 0; i < page.numRadios; ++i){
+        if(radios[i].bUpdate){
+            writeIfChanged(*(radios[i].pParami), radios[i].value.load());
+            radios[i].bUpdate = false;
+        }
+    }
+
+	static const float stopvalue = 0.00001f;
+
+    // knob update, our own writes must not re-arm pickup
+    bWritingKnobs = true;
+    for(size_t i = 0; i < knobs.size(); ++i){
+        for(size_t k = 0; k < knobs[i].size(); k++){
+            if(knobs[i][k].bUpdate){
+                switch(knobs[i][k].typeCode){
+                 case LC_TYPECODE_FLOAT:
+                     if(bEasing){
+                         // lpf code
+                         float xn = (knobs[i][k].value * easeAmount + knobs[i][k].z1 * (1.0f - easeAmount));
+                         knobs[i][k].z1 = xn;
+                         if(abs(knobs[i][k].value - knobs[i][k].z1) < stopvalue){
+                             knobs[i][k].z1 = knobs[i][k].value;
                              knobs[i][k].bUpdate = false;
-                         }
-                         break;
-
-                     case LC_TYPECODE_INT:
-                         if(bEasing){
-                             // lpf code
-                             float xn = (knobs[i][k].value * easeAmount + knobs[i][k].z1 * (1.0f - easeAmount));
-                             knobs[i][k].z1 = xn;
-                             if(abs(knobs[i][k].value - knobs[i][k].z1) < stopvalue){
-                                 knobs[i][k].z1 = knobs[i][k].value;
-                                 knobs[i][k].bUpdate = false;
-                             }else{
-                                 bUpdate = true;    // keeps global update alive
-                             }
-                             *(knobs[i][k].pParami) = (int)knobs[i][k].z1;
                          }else{
-                             // just set value
-                             *(knobs[i][k].pParami) = (int)knobs[i][k].value;
+                             bUpdate = true;    // keeps global update alive
+                         }
+                         writeIfChanged(*(knobs[i][k].pParamf), knobs[i][k].z1);
+                     }else{
+                         // just set value
+                         writeIfChanged(*(knobs[i][k].pParamf), knobs[i][k].value.load());
+                         knobs[i][k].bUpdate = false;
+                     }
+                     break;
+
+                 case LC_TYPECODE_INT:
+                     if(bEasing){
+                         // lpf code
+                         float xn = (knobs[i][k].value * easeAmount + knobs[i][k].z1 * (1.0f - easeAmount));
+                         knobs[i][k].z1 = xn;
+                         if(abs(knobs[i][k].value - knobs[i][k].z1) < stopvalue){
+                             knobs[i][k].z1 = knobs[i][k].value;
                              knobs[i][k].bUpdate = false;
+                         }else{
+                             bUpdate = true;    // keeps global update alive
                          }
-                         break;
-
-                     case LC_TYPECODE_VECTOR3:
-                         auto & knob = knobs[i][k];
-                         auto & values = knob.values;
-                         if(bEasing){
-                             // lpf code
-                             float xn = (values[0] * easeAmount + knob.z3.x * (1.0f - easeAmount));
-                             float yn = (values[1] * easeAmount + knob.z3.y * (1.0f - easeAmount));
-                             float zn = (values[2] * easeAmount + knob.z3.z * (1.0f - easeAmount));
-                             knob.z3 = glm::vec3(xn, yn, zn);
-                             if(abs(values[0] - knob.z3.x) < stopvalue
-                                && abs(values[1] - knob.z3.y) < stopvalue
-                                && abs(values[2] - knob.z3.z) < stopvalue){
-                                 knob.z3 = glm::vec3(values[0].load(), values[1].load(), values[2].load());
-                                 knob.bUpdate = false;
-                             }else{
-                                 bUpdate = true;    // keeps global update alive
-                             }
-                             *(knob.pParamv3) = knob.z3;
+                         writeIfChanged(*(knobs[i][k].pParami), (int)knobs[i][k].z1);
+                     }else{
+                         // just set value
+                         writeIfChanged(*(knobs[i][k].pParami), (int)knobs[i][k].value);
+                         knobs[i][k].bUpdate = false;
+                     }
+                     break;
+
+                 case LC_TYPECODE_VECTOR3:
+                     auto & knob = knobs[i][k];
+                     auto & values = knob.values;
+                     if(bEasing){
+                         // lpf code
+                         float xn = (values[0] * easeAmount + knob.z3.x * (1.0f - easeAmount));
+                         float yn = (values[1] * easeAmount + knob.z3.y * (1.0f - easeAmount));
+                         float zn = (values[2] * easeAmount + knob.z3.z * (1.0f - easeAmount));
+                         knob.z3 = glm::vec3(xn, yn, zn);
+                         if(abs(values[0] - knob.z3.x) < stopvalue
+                            && abs(values[1] - knob.z3.y) < stopvalue
+                            && abs(values[2] - knob.z3.z) < stopvalue){
+                             knob.z3 = glm::vec3(values[0].load(), values[1].load(), values[2].load());
+                             knob.bUpdate = false;
                          }else{
-                             // just set value
-                             *(knobs[i][k].pParamv3) = glm::vec3(values[0].load(), values[1].load(), values[2].load());
-                             knobs[i][k].bUpdate = false;
+                             bUpdate = true;    // keeps global update alive
                          }
-                         break;
-                    }
+                         writeIfChanged(*(knob.pParamv3), knob.z3);
+                     }else{
+                         // just set value
+                         writeIfChanged(*(knobs[i][k].pParamv3), glm::vec3(values[0].load(), values[1].load(), values[2].load()));
+                         knobs[i][k].bUpdate = false;
+                     }
+                     break;
                 }
             }
         }
+    }
 
-        // update leds
-        if(buttonLedsEnabled){
-            refreshLeds();
+    bWritingKnobs = false;
+
+    // nrpn update, no easing: the data is already 14 bit
+    for(auto & binding : page.nrpns){
+        if(binding.bUpdate){
+            if(binding.typeCode == LC_TYPECODE_FLOAT){
+                writeIfChanged(*(binding.pParamf), binding.value.load());
+            }else if(binding.typeCode == LC_TYPECODE_INT){
+                writeIfChanged(*(binding.pParami), (int)binding.value);
+            }
+            binding.bUpdate = false;
         }
     }
-
 }
 
 void ofxControllerBase::newMidiMessage(ofxMidiMessage & msg){
 
+    // clock, sensing, sysex and unwanted types never reach the buffer
+    if(!(inputTypeOf(msg.status) & inputTypes.load(std::memory_order_relaxed))){
+        return;
+    }
+
+    // other templates and devices on the same port
+    if(msg.channel < 1 || msg.channel > 16
+       || !(channelMask.load(std::memory_order_relaxed) & (1 << (msg.channel - 1)))){
+        return;
+    }
+
+    uint64_t now = ofxControllerClock::now();
+
+    if(numSubscribers.load(std::memory_order_relaxed) > 0){
+        publishEvent(msg, now);
+    }
+
+    // other accepted channels are only buffered, for the modifiers
+    bool own = isOwnChannel(msg.channel);
+
+    // MIDI thread callbacks, on press and release edges
+    if(own && midiCallbacksBound.load(std::memory_order_relaxed)){
+        bool pressed;
+        int source = callbackSource(msg, pressed);
+        if(source >= 0 && pressed != (midiHeld[source] != 0)){
+            midiHeld[source] = pressed;
+            auto & slot = midiCallbacks[source * 2 + (pressed ? 0 : 1)];
+            if(slot.armed){
+                slot.busy++;
+                if(slot.armed){ // re-checked, the binding may be changing
+                    slot.callback();
+                }
+                slot.busy--;
+            }
+        }
+    }
+
+    // immediate bindings are dispatched here on the MIDI thread
+    if(own && msg.status == MIDI_CONTROL_CHANGE && msg.control >= 0 && msg.control < int(knobIndexForCC.size())){
+        int index = knobIndexForCC[msg.control];
+        if(index >= 0){
+            knobTimes[index].store(now, std::memory_order_relaxed);
+            auto & slot = immediates[index];
+            uint32_t generation = slot.generation.load(std::memory_order_acquire);
+            std::atomic <float> * target = slot.target.load(std::memory_order_relaxed);
+            if(!(generation & 1) && target){
+                std::atomic <uint64_t> * time = slot.time.load(std::memory_order_relaxed);
+                float value = slot.lut[msg.value & 0x7F].load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                // a rebind raced this read, the buffered bindings still get the message
+                if(slot.generation.load(std::memory_order_relaxed) == generation){
+                    if(time){
+                        time->store(now, std::memory_order_relaxed);
+                    }
+                    target->store(value, std::memory_order_relaxed);
+                }
+            }
+        }
+    }else if(own && (msg.status == MIDI_NOTE_ON || msg.status == MIDI_NOTE_OFF) && msg.pitch >= 0 && msg.pitch < int(buttonIndexForNote.size())){
+        int index = buttonIndexForNote[msg.pitch];
+        if(index >= 0){
+            buttonTimes[index].store(now, std::memory_order_relaxed);
+        }
+    }
+
     int write = written;
 
     buffer[write] = msg;
+    bufferTimes[write] = now;
 
     write++;
     if(write >= int(buffer.size())){
@@ -209,67 +689,132 @@ void ofxControllerBase::newMidiMessage(ofxMidiMessage & msg){
 
 }
 
-void ofxControllerBase::processMessage(const ofxMidiMessage & msg){
+void ofxControllerBase::processMessage(const ofxMidiMessage & msg, uint64_t time){
   ofLogVerbose() << "ofxControllerBase::processMessage MIDI message received: " << msg.status << " control: " << msg.control << " value: " << msg.value << " pitch: " << msg.pitch;
 
-    bUpdate = true;
+    if(processModifier(msg)){
+        return;
+    }
+
+    // e.g. the channel of a modifierCC(), not ours to dispatch
+    if(!isOwnChannel(msg.channel)){
+        return;
+    }
+
+    auto & buttons = active->buttons;
+    auto & ccButtons = active->ccButtons;
+    auto & radios = active->radios;
+    auto & knobs = active->knobs;
+
+    bool dirty = false; // only matched bindings trigger an update sweep
+
+    // raw control state for the published snapshot
+    if(msg.status == MIDI_CONTROL_CHANGE && msg.control >= 0 && msg.control < int(knobIndexForCC.size())){
+        int index = knobIndexForCC[msg.control];
+        if(index >= 0 && index < ofxControllerState::maxKnobs){
+            state.knobs[index] = msg.value;
+            bStateChanged = true;
+        }
+    }else if((msg.status == MIDI_NOTE_ON || msg.status == MIDI_NOTE_OFF) && msg.pitch >= 0 && msg.pitch < int(buttonIndexForNote.size())){
+        int index = buttonIndexForNote[msg.pitch];
+        if(index >= 0 && index < ofxControllerState::maxButtons){
+            state.buttons[index] = (msg.status == MIDI_NOTE_ON && msg.velocity > 0) ? 1 : 0;
+            bStateChanged = true;
+        }
+
+        // page buttons work on every page and take over the button bindings
+        if(index >= 0 && index < (int)pageForButton.size() && pageForButton[index] >= 0){
+            if(msg.status == MIDI_NOTE_ON && msg.velocity > 0){
+                setPage(pageForButton[index]);
+            }
+            return;
+        }
+    }
+
+    // button callbacks and gestures, a press on another page or layer is
+    // released on this one, otherwise its gesture would never end
+    {
+        bool pressed;
+        int source = callbackSource(msg, pressed);
+        if(source >= 0){
+            if(pressed && !active->callbacks.empty()){
+                gesturePress(source, time);
+            }else if(!pressed && gestures[source] != LC_GESTURE_IDLE){
+                gestureRelease(source, time);
+            }
+        }
+    }
 
      switch(msg.status){
       case MIDI_CONTROL_CHANGE:
+          if(!active->nrpns.empty() && processNrpn(msg, dirty)){
+              break;
+          }
+
           for(size_t i = 0; i < knobs.size(); ++i){
               for(size_t k = 0; k < knobs[i].size(); k++){
-                  if(knobs[i][k].typeCode == LC_TYPECODE_VECTOR3 && (msg.control >= knobs[i][k].controlNum || msg.control < knobs[i][k].controlNum + 3)){
+                  if(knobs[i][k].typeCode == LC_TYPECODE_VECTOR3 && (msg.control >= knobs[i][k].controlNum && msg.control < knobs[i][k].controlNum + 3)){
  //                     if(!knobs[i][k].bUpdate.load()) {
                          int index = msg.control - knobs[i][k].controlNum;
                          float min = glm::value_ptr(knobs[i][k].minv3)[index];
                          float max = glm::value_ptr(knobs[i][k].maxv3)[index];
                          knobs[i][k].values[index].store(ofMap(msg.value, 0, 127, min, max));
                          knobs[i][k].bUpdate.store(true);
+                         dirty = true;
  //                     }
-                   }else if(msg.control == knobs[i][k].controlNum && knobs[i][k].typeCode != LC_TYPECODE_UNASSIGNED){
+                   }else if((msg.control == knobs[i][k].controlNum || msg.control == knobs[i][k].lsbControl) && knobs[i][k].typeCode != LC_TYPECODE_UNASSIGNED){
                        auto & binding = knobs[i][k];
+                       int midi = msg.value & 0x7F;
+                       float position = midi; // in the lookup table
+
+                       // 14 bit pair: the msb applies at once as a 7 bit value, so 127 still
+                       // reaches the maximum, a following lsb refines it to the full range
+                       bool lsb = msg.control == binding.lsbControl;
+                       if(binding.lsbControl >= 0){
+                           if(lsb){
+                               position = ((binding.msb << 7) | midi) * (127.0f / 16383.0f);
+                               midi = binding.msb;
+                           }else{
+                               binding.msb = midi;
+                           }
+                       }
 
-                       // Soft takeover: ignore knob changes until the physical control
-                       // reaches the current parameter value (within tolerance).
-                       if(binding.pickupEnabled && binding.pickupArmed){
-                           float currentMidi = 0.0f;
-                           switch(binding.typeCode){
-                            case LC_TYPECODE_FLOAT:
-                                if(binding.pParamf){
-                                    // Map without clamping first, then clamp to valid MIDI range.
-                                    // This allows values outside min/max to still pickup at endpoints.
-                                    currentMidi = ofMap(*(binding.pParamf), binding.minf, binding.maxf, 0.0f, 127.0f, false);
-                                    currentMidi = ofClamp(currentMidi, 0.0f, 127.0f);
-                                }
-                                break;
-                            case LC_TYPECODE_INT:
-                                if(binding.pParami){
-                                    // Map without clamping first, then clamp to valid MIDI range.
-                                    currentMidi = ofMap((float)*(binding.pParami), (float)binding.mini, (float)binding.maxi, 0.0f, 127.0f, false);
-                                    currentMidi = ofClamp(currentMidi, 0.0f, 127.0f);
-                                }
-                                break;
-                            default:
-                                break;
+                       // endless encoders: deltas of a burst add up into one write
+                       if(binding.relative){
+                           if(moveEncoder(binding, midi, time)){
+                               binding.bUpdate = true;
+                               dirty = true;
                            }
+                           continue;
+                       }
+
+                       // deadband against fader noise, the range ends always pass
+                       if(!lsb && binding.deadband > 0 && binding.acceptedMidi >= 0 && midi != 0 && midi != 127
+                          && std::abs(midi - binding.acceptedMidi) < binding.deadband){
+                           continue;
+                       }
+                       binding.acceptedMidi = midi;
 
-                           if(std::abs((float)msg.value - currentMidi) > binding.pickupTolerance){
+                       // Soft takeover: the pickup target is cached in MIDI space and
+                       // only recomputed after the parameter changed from elsewhere.
+                       if(binding.takeover != LC_TAKEOVER_JUMP && binding.pickup->armed){
+                           if(binding.pickup->dirty.exchange(false)){
+                               binding.pickupMidi = pickupPosition(binding);
+                           }
+                           if(!checkTakeover(binding, midi)){
+                               binding.lastMidi = midi;
+                               dirty = dirty || binding.bUpdate; // scaling moves the value
                                continue;
                            }
-
-                           binding.pickupArmed = false;
+                           binding.pickup->armed = false;
                        }
+                       binding.lastMidi = midi;
 
-                       switch(binding.typeCode){
-                        case LC_TYPECODE_FLOAT:
-                            binding.value = ofMap(msg.value, 0, 127, binding.minf, binding.maxf);
-                            break;
- 
-                        case LC_TYPECODE_INT:
-                            binding.value = ofMap(msg.value, 0, 127, binding.mini, binding.maxi);
-                            break;
+                       if(binding.typeCode == LC_TYPECODE_FLOAT || binding.typeCode == LC_TYPECODE_INT){
+                           binding.value = binding.lsbControl >= 0 ? lutValue(binding.lut, position) : binding.lut[midi];
                        }
                        binding.bUpdate = true;
+                       dirty = true;
                    }
               }
           }
@@ -278,6 +823,7 @@ void ofxControllerBase::processMessage(const ofxMidiMessage & msg){
               if(msg.control == ccButtons[b].controlNum && ccButtons[b].typeCode == LC_TYPECODE_BOOL){
                   ccButtons[b].bActive = msg.value > 64;
                   ccButtons[b].bUpdate = true;
+                  dirty = true;
               }
           }
 
@@ -291,16 +837,19 @@ void ofxControllerBase::processMessage(const ofxMidiMessage & msg){
                   case 0:       // toggle
                       buttons[b].bActive = buttons[b].bActive ? false : true;
                       buttons[b].bUpdate = true;
+                      dirty = true;
                       break;
 
                   case 1:       // momentary
                       buttons[b].bActive = true;
                       buttons[b].bUpdate = true;
+                      dirty = true;
                       break;
 
                   case 2:       // radio
                       radios[buttons[b].radioGroup].value = buttons[b].radioValue;
                       radios[buttons[b].radioGroup].bUpdate = true;
+                      dirty = true;
                       break;
                  }
              }
@@ -313,6 +862,7 @@ void ofxControllerBase::processMessage(const ofxMidiMessage & msg){
                  if(buttons[b].buttonMode == 1){       // momentary
                      buttons[b].bActive = false;
                      buttons[b].bUpdate = true;
+                     dirty = true;
                  }
              }
          }
@@ -322,8 +872,132 @@ void ofxControllerBase::processMessage(const ofxMidiMessage & msg){
          break;
     }
 
+    if(dirty){
+        bUpdate = true;
+    }
+
+}
+
+void ofxControllerBase::publishState(){
+    for(int i = 0; i < ofxControllerState::maxKnobs && i < (int)knobTimes.size(); ++i){
+        state.knobTimes[i] = knobTimes[i].load(std::memory_order_relaxed);
+    }
+    for(int i = 0; i < ofxControllerState::maxButtons && i < (int)buttonTimes.size(); ++i){
+        state.buttonTimes[i] = buttonTimes[i].load(std::memory_order_relaxed);
+    }
+
+    auto & knobs = active->knobs;
+    auto & radios = active->radios;
+
+    for(int i = 0; i < ofxControllerState::maxKnobs && i < (int)knobs.size(); ++i){
+        float value = state.knobs[i] / 127.0f;
+        if(!knobs[i].empty() && (knobs[i][0].typeCode == LC_TYPECODE_FLOAT || knobs[i][0].typeCode == LC_TYPECODE_INT)){
+            value = knobs[i][0].value;
+        }
+        state.values[i] = value;
+    }
+
+    state.numRadios = 0;
+    for(int i = 0; i < active->numRadios && state.numRadios < ofxControllerState::maxRadios; ++i){
+        state.radios[state.numRadios++] = radios[i].pParami ? radios[i].pParami->get() : radios[i].value.load();
+    }
+
+    state.sequence++;
+    state.time = ofxControllerClock::now();
+    publishedState.write(state);
+    if(sharedState){
+        sharedState->publish(state);
+    }
+    bStateChanged = false;
+}
+
+std::shared_ptr <ofxControllerEventQueue> ofxControllerBase::subscribe(const ofxControllerEventFilter & filter, size_t capacity){
+    for(int i = 0; i < maxSubscribers; ++i){
+        auto & subscriber = subscribers[i];
+        if(!subscriber.owner){
+            subscriber.owner = std::make_shared <ofxControllerEventQueue>(filter, capacity);
+            subscriber.queue.store(subscriber.owner.get(), std::memory_order_release);
+            numSubscribers++;
+            return subscriber.owner;
+        }
+    }
+    ofLogError() << "ofxLaunchControls: too many subscribers for subscribe() function, ignored";
+    return nullptr;
+}
+
+void ofxControllerBase::unsubscribe(const std::shared_ptr <ofxControllerEventQueue> & queue){
+    for(int i = 0; i < maxSubscribers; ++i){
+        auto & subscriber = subscribers[i];
+        if(queue && subscriber.owner == queue){
+            subscriber.queue = nullptr;
+            while(subscriber.busy > 0){
+                std::this_thread::yield(); // a push in progress still uses the queue
+            }
+            subscriber.owner.reset();
+            numSubscribers--;
+        }
+    }
+}
+
+void ofxControllerBase::publishEvent(const ofxMidiMessage & msg, uint64_t time){
+    ofxControllerEvent event;
+    event.time = time;
+    if(msg.status == MIDI_CONTROL_CHANGE){
+        int index = msg.control >= 0 && msg.control < int(knobIndexForCC.size()) ? knobIndexForCC[msg.control] : -1;
+        event.raw = msg.value & 0x7F;
+        if(index >= 0){
+            event.kind = ofxControllerEvent::Knob;
+            event.index = index;
+            event.scaled = event.raw / 127.0f;
+        }else{
+            event.kind = ofxControllerEvent::ControlButton;
+            event.index = msg.control;
+            event.scaled = event.raw > 64 ? 1.0f : 0.0f;
+        }
+    }else if((msg.status == MIDI_NOTE_ON || msg.status == MIDI_NOTE_OFF) && msg.pitch >= 0 && msg.pitch < int(buttonIndexForNote.size())){
+        event.kind = ofxControllerEvent::Button;
+        event.index = buttonIndexForNote[msg.pitch];
+        event.raw = msg.velocity & 0x7F;
+        event.scaled = (msg.status == MIDI_NOTE_ON && msg.velocity > 0) ? 1.0f : 0.0f;
+    }else{
+        return;
+    }
+
+    for(int i = 0; i < maxSubscribers; ++i){
+        auto & subscriber = subscribers[i];
+        if(subscriber.queue.load(std::memory_order_relaxed)){
+            subscriber.busy++;
+            ofxControllerEventQueue * queue = subscriber.queue; // re-checked, may be unsubscribing
+            if(queue && queue->getFilter().matches(event)){
+                queue->push(event);
+            }
+            subscriber.busy--;
+        }
+    }
+}
+
+ofxControllerBase::EventSubscriber::EventSubscriber(){
+    queue = nullptr;
+    busy = 0;
 }
 
+void ofxControllerBase::getState(ofxControllerState & out) const {
+    publishedState.read(out);
+}
+
+bool ofxControllerBase::publishSharedState(const std::string & segmentName){
+    auto publisher = std::make_unique <ofxControllerStatePublisher>();
+    if(!publisher->setup(segmentName)){
+        return false;
+    }
+    sharedState = std::move(publisher);
+    bStateChanged = true; // readers get a full state on the next update
+    return true;
+}
+
+void ofxControllerBase::stopSharedState(){
+    sharedState.reset();
+}
 
 // init values
 ofxControllerBase::Binding::Binding(){
@@ -336,16 +1010,28 @@ ofxControllerBase::Binding::Binding(){
     pParamf = nullptr;
     pParami = nullptr;
     pParamb = nullptr;
-    buttonListener = nullptr;
 
     value = 0;
     values[0] = 0.0f;
     values[1] = 0.0f;
     values[2] = 0.0f;
 
-    pickupEnabled = false;
-    pickupArmed = false;
+    takeover = LC_TAKEOVER_JUMP;
+    pickup = nullptr;
     pickupTolerance = 2;
+    pickupMidi = 0.0f;
+    lastMidi = -1;
+    deadband = 0;
+    acceptedMidi = -1;
+
+    relative = false;
+    encoderMode = LC_ENCODER_OFFSET_64;
+    encoderStep = 0.0f;
+    encoderAcceleration = 1.0f;
+    lastEventTime = 0;
+
+    lsbControl = -1;
+    msb = 0;
 
     minf = 0.0f;
     maxf = 0.0f;
@@ -353,6 +1039,7 @@ ofxControllerBase::Binding::Binding(){
     maxi = 0;
     minv3 = glm::vec3(0.0f);
     maxv3 = glm::vec3(0.0f);
+    std::fill(lut, lut + ofxControllerCurve::tableSize, 0.0f);
 
     bActive = false;
     radioGroup = -1;
@@ -371,16 +1058,28 @@ ofxControllerBase::Binding::Binding(const Binding & other){
     pParamf = other.pParamf;
     pParami = other.pParami;
     pParamb = other.pParamb;
-    buttonListener = other.buttonListener;
 
     value.store(other.value);
     values[0].store(other.values[0]);
     values[1].store(other.values[1]);
     values[2].store(other.values[2]);
 
-    pickupEnabled = other.pickupEnabled;
-    pickupArmed = other.pickupArmed;
+    takeover = other.takeover;
+    pickup = other.pickup;
     pickupTolerance = other.pickupTolerance;
+    pickupMidi = other.pickupMidi;
+    lastMidi = other.lastMidi;
+    deadband = other.deadband;
+    acceptedMidi = other.acceptedMidi;
+
+    relative = other.relative;
+    encoderMode = other.encoderMode;
+    encoderStep = other.encoderStep;
+    encoderAcceleration = other.encoderAcceleration;
+    lastEventTime = other.lastEventTime;
+
+    lsbControl = other.lsbControl;
+    msb = other.msb;
 
     minf = other.minf;
     maxf = other.maxf;
@@ -388,6 +1087,7 @@ ofxControllerBase::Binding::Binding(const Binding & other){
     maxi = other.maxi;
     minv3 = other.minv3;
     maxv3 = other.maxv3;
+    std::copy(other.lut, other.lut + ofxControllerCurve::tableSize, lut);
 
     bActive.store(other.bActive);
     radioGroup = other.radioGroup;
@@ -396,18 +1096,39 @@ ofxControllerBase::Binding::Binding(const Binding & other){
     z3 = other.z3;
 }
 
+bool ofxControllerBase::Binding::sameAs(const Binding & other) const {
+    // rebinding a knob makes new takeover flags, so they tell the bindings apart
+    return typeCode == other.typeCode && controlNum == other.controlNum && buttonMode == other.buttonMode
+        && pParamv3 == other.pParamv3 && pParamf == other.pParamf && pParami == other.pParami && pParamb == other.pParamb
+        && pickup == other.pickup && relative == other.relative
+        && radioGroup == other.radioGroup && radioValue == other.radioValue;
+}
+
+void ofxControllerBase::Binding::carryState(const Binding & live){
+    bUpdate.store(live.bUpdate);
+    value.store(live.value);
+    values[0].store(live.values[0]);
+    values[1].store(live.values[1]);
+    values[2].store(live.values[2]);
+    bActive.store(live.bActive);
+    pickupMidi = live.pickupMidi;
+    lastMidi = live.lastMidi;
+    acceptedMidi = live.acceptedMidi;
+    lastEventTime = live.lastEventTime;
+    msb = live.msb;
+    z1 = live.z1;
+    z3 = live.z3;
+}
+
 void ofxControllerBase::button(int index, std::function<void()> buttonListener){
-  if(midiIn.isOpen()){
-    if(index >= 0 && index < (int)buttons.size()){
-      buttons[index].buttonListener = buttonListener;
-    }else{
-      ofLogError() << "ofxLaunchControls: wrong indices for button(), momentary() or toggle() function, binding ignored";
-    }
-  }
+    onButton(index, LC_BUTTON_PRESS, buttonListener);
 }
 
 void ofxControllerBase::button(int index, ofParameter <bool> & param, bool momentary){
-    if(midiIn.isOpen()){
+    if(isBindable()){
+        std::lock_guard <std::recursive_mutex> lock(bindingMutex);
+        auto & page = editedSet();
+        auto & buttons = page.buttons;
         if(index >= 0 && index < (int)buttons.size()){
             buttons[index].typeCode = LC_TYPECODE_BOOL;
             buttons[index].pParamb = &param;
@@ -416,8 +1137,9 @@ void ofxControllerBase::button(int index, ofParameter <bool> & param, bool momen
             }else{
                 buttons[index].buttonMode = 0;
             }
-            param.addListener(this, &ofxControllerBase::buttonChangedB);
-            refreshLeds();
+            page.buttonListeners[index] = std::make_shared <ofEventListener>(param.newListener([this, index](bool &){
+                markLed(index);
+            }));
         }else{
             ofLogError() << "ofxLaunchControls: wrong indices for button(), momentary() or toggle() function, binding ignored";
         }
@@ -425,7 +1147,10 @@ void ofxControllerBase::button(int index, ofParameter <bool> & param, bool momen
 }
 
 void ofxControllerBase::button(int index, ofParameter <float> & param, float min, float max, bool momentary){
-    if(midiIn.isOpen()){
+    if(isBindable()){
+        std::lock_guard <std::recursive_mutex> lock(bindingMutex);
+        auto & page = editedSet();
+        auto & buttons = page.buttons;
         if(index >= 0 && index < (int)buttons.size()){
             buttons[index].typeCode = LC_TYPECODE_FLOAT;
             buttons[index].pParamf = &param;
@@ -437,8 +1162,9 @@ void ofxControllerBase::button(int index, ofParameter <float> & param, float min
                 buttons[index].buttonMode = 0;
             }
 
-            param.addListener(this, &ofxControllerBase::buttonChangedF);
-            refreshLeds();
+            page.buttonListeners[index] = std::make_shared <ofEventListener>(param.newListener([this, index](float &){
+                markLed(index);
+            }));
         }else{
             ofLogError() << "ofxLaunchControls: wrong indices for button(), momentary() or toggle() function, binding ignored";
         }
@@ -446,7 +1172,10 @@ void ofxControllerBase::button(int index, ofParameter <float> & param, float min
 }
 
 void ofxControllerBase::button(int index, ofParameter <int> & param, int min, int max, bool momentary){
-    if(midiIn.isOpen()){
+    if(isBindable()){
+        std::lock_guard <std::recursive_mutex> lock(bindingMutex);
+        auto & page = editedSet();
+        auto & buttons = page.buttons;
         if(index >= 0 && index < (int)buttons.size()){
             buttons[index].typeCode = LC_TYPECODE_INT;
             buttons[index].pParami = &param;
@@ -457,8 +1186,9 @@ void ofxControllerBase::button(int index, ofParameter <int> & param, int min, in
             }else{
                 buttons[index].buttonMode = 0;
             }
-            param.addListener(this, &ofxControllerBase::buttonChangedI);
-            refreshLeds();
+            page.buttonListeners[index] = std::make_shared <ofEventListener>(param.newListener([this, index](int &){
+                markLed(index);
+            }));
         }else{
             ofLogError() << "ofxLaunchControls: wrong indices for button(), momentary() or toggle() function, binding ignored";
         }
@@ -467,73 +1197,86 @@ void ofxControllerBase::button(int index, ofParameter <int> & param, int min, in
 
 // remember to change midi channel
 void ofxControllerBase::refreshLeds(){
+    if(!active){
+        return; // not setup yet
+    }
+    bRefreshLeds = false;
+    bLedsDirty = false;
+    for(size_t b = 0; b < numLeds; ++b){
+        ledDirty[b] = false;
+        refreshLed(b);
+    }
+}
 
-    for(size_t b = 0; b < buttons.size(); ++b){
-
-        if(buttons[b].typeCode > 0 && buttons[b].typeCode != LC_TYPECODE_RADIO){
+void ofxControllerBase::refreshLed(int b){
+    if(!active || b < 0 || b >= (int)active->buttons.size()){
+        return;
+    }
+    auto & button = active->buttons[b];
 
-            switch(buttons[b].typeCode){
-             case LC_TYPECODE_BOOL:
-                 buttons[b].bActive = *(buttons[b].pParamb);
-                 break;
+    if(pageForButton[b] >= 0){
+        sendLed(buttonsNote[b], pageForButton[b] == basePage ? buttonsColor : ofxLCLeds::Off);
+        return;
+    }
 
-             case LC_TYPECODE_FLOAT:
-                 if(*(buttons[b].pParamf) > buttons[b].minf){
-                     buttons[b].bActive = true;
-                 }else{
-                     buttons[b].bActive = false;
-                 }
-                 break;
+    switch(button.typeCode){
+     case LC_TYPECODE_BOOL:
+         button.bActive = *(button.pParamb);
+         break;
 
-             case LC_TYPECODE_INT:
-                 if(*(buttons[b].pParami) > buttons[b].mini){
-                     buttons[b].bActive = true;
-                 }else{
-                     buttons[b].bActive = false;
-                 }
-                 break;
-            }
+     case LC_TYPECODE_FLOAT:
+         button.bActive = *(button.pParamf) > button.minf;
+         break;
 
-            if(buttons[b].bActive){
-                leds.sendNoteOn(channel, buttons[b].controlNum, buttonsColor);
-            }else{
-                leds.sendNoteOn(channel, buttons[b].controlNum, ofxLCLeds::Off);
-            }
+     case LC_TYPECODE_INT:
+         button.bActive = *(button.pParami) > button.mini;
+         break;
 
-            buttons[b].bUpdate = false;
-        }
-    }
+     case LC_TYPECODE_RADIO:{
+         auto & radio = active->radios[button.radioGroup];
+         if(button.radioValue == *(radio.pParami)){
+             sendLed(button.controlNum, radio.color);
+         }else{
+             sendLed(button.controlNum, radio.offColor);
+         }
+         return;
+     }
 
-    for(size_t i = 0; i < radios.size(); ++i){
-        for(int k = radios[i].min; k <= radios[i].max; ++k){
-            if(k == *(radios[i].pParami) + radios[i].min){
-                leds.sendNoteOn(channel, buttons[k].controlNum, radios[i].color);
-            }else{
-                leds.sendNoteOn(channel, buttons[k].controlNum, radios[i].offColor);
-            }
-        }
+     default:
+         return; // unassigned, switchPage() turned it off
     }
 
+    if(button.bActive){
+        sendLed(button.controlNum, buttonsColor);
+    }else{
+        sendLed(button.controlNum, ofxLCLeds::Off);
+    }
+    button.bUpdate = false;
 }
 
 void ofxControllerBase::clearLeds(){
-    for(size_t b = 0; b < buttons.size(); ++b){
-        leds.sendNoteOn(channel, buttons[b].controlNum, ofxLCLeds::Off);
+    for(size_t b = 0; b < buttonsNote.size(); ++b){
+        sendLed(buttonsNote[b], ofxLCLeds::Off);
     }
 }
 
 void ofxControllerBase::radio(int indexMin, int indexMax, ofParameter <int> & param, int color, int offColor){
-    if(midiIn.isOpen()){
-        if(indexMin >= 0 && indexMax <= (int)buttons.size() && indexMin <= indexMax){
-
-            radios.emplace_back();
-            radios.back().min = indexMin;
-            radios.back().max = indexMax;
-
-            radios.back().pParami = &param;
-            radios.back().bUpdate = false;
-            radios.back().color = color;
-            radios.back().offColor = offColor;
+    if(isBindable()){
+        std::lock_guard <std::recursive_mutex> lock(bindingMutex);
+        auto & page = editedSet();
+        auto & buttons = page.buttons;
+        if(page.numRadios >= maxRadios){
+            ofLogError() << "ofxLaunchControls: too many radio groups for radio() function, binding ignored";
+        }else if(indexMin >= 0 && indexMax < (int)buttons.size() && indexMin <= indexMax){
+            int g = page.numRadios++;
+            auto & radio = page.radios[g];
+            radio.min = indexMin;
+            radio.max = indexMax;
+
+            radio.pParami = &param;
+            radio.bUpdate = false;
+            radio.color = color;
+            radio.offColor = offColor;
 
             int val = param;
             if(val < 0){
@@ -544,17 +1287,29 @@ void ofxControllerBase::radio(int indexMin, int indexMax, ofParameter <int> & pa
                 val = max;
             }
 
-            radios.back().value = val;
+            radio.value = val;
+            radio.lit = std::make_shared <std::atomic <int> >(param.get());
 
             for(int b = indexMin; b <= indexMax; ++b){
                 buttons[b].buttonMode = 2;
                 buttons[b].typeCode = LC_TYPECODE_RADIO;
                 buttons[b].radioValue = b - indexMin; // radio value that the button will set
-                buttons[b].radioGroup = radios.size() - 1;
+                buttons[b].radioGroup = g;
             }
-            param.addListener(this, &ofxControllerBase::radioChanged);
 
-            refreshLeds();
+            // a new selection only turns the old led off and the new one on
+            auto lit = radio.lit;
+            page.radioListeners[g] = std::make_shared <ofEventListener>(param.newListener([this, indexMin, max, lit](int & value){
+                int previous = lit->exchange(value);
+                if(previous != value){
+                    if(previous >= 0 && previous <= max){
+                        markLed(indexMin + previous);
+                    }
+                    if(value >= 0 && value <= max){
+                        markLed(indexMin + value);
+                    }
+                }
+            }));
         }else{
             ofLogError() << "ofxLaunchControls: wrong indices for radio() function, binding ignored";
         }
@@ -579,96 +1334,329 @@ ofxControllerBase::RadioGroup::RadioGroup(const RadioGroup & other){
     bUpdate.store(other.bUpdate);
     color = other.color;
     offColor = other.offColor;
+    lit = other.lit;
 }
 
 
-void ofxControllerBase::knob(int index, ofParameter <float> & param, float min, float max){
-    if(midiIn.isOpen()){
+ofxControllerBase::Binding & ofxControllerBase::addKnobBinding(int index){
+    auto & page = editedSet();
+    auto & knobs = page.knobs;
+    knobs[index].emplace_back();
+    page.knobListeners[index].emplace_back();
+    knobs[index].back().controlNum = knobsCC[index];
+    return knobs[index].back();
+}
+
+void ofxControllerBase::knob(int index, ofParameter <float> & param, float min, float max, const ofxControllerCurve & curve){
+    knobTakeover(index, param, min, max, LC_TAKEOVER_JUMP, 2, curve);
+}
+
+void ofxControllerBase::knob(int index, ofParameter <int> & param, int min, int max, const ofxControllerCurve & curve){
+    knobTakeover(index, param, min, max, LC_TAKEOVER_JUMP, 2, curve);
+}
+
+void ofxControllerBase::knobTakeover(int index, ofParameter <float> & param, float min, float max, TakeoverMode mode, int tolerance, const ofxControllerCurve & curve){
+    if(isBindable()){
+        std::lock_guard <std::recursive_mutex> lock(bindingMutex);
+        auto & knobs = editedSet().knobs;
         if(index >= 0 && index < (int)knobs.size()){
-            knobs[index].emplace_back();
-            knobs[index].back().controlNum = knobsCC[index];
-            knobs[index].back().typeCode = LC_TYPECODE_FLOAT;
-            knobs[index].back().pParamf = &param;
-            knobs[index].back().maxf = max;
-            knobs[index].back().minf = min;
-            knobs[index].back().value = param;
-            knobs[index].back().z1 = param;
+            auto & binding = addKnobBinding(index);
+            binding.typeCode = LC_TYPECODE_FLOAT;
+            binding.pParamf = &param;
+            binding.maxf = max;
+            binding.minf = min;
+            curve.fill(binding.lut, min, max);
+            binding.value = param;
+            binding.z1 = param;
+            setupTakeover(binding, mode, tolerance);
+
+            if(mode != LC_TAKEOVER_JUMP){
+                // changed by the app, a preset or a gui: the control is out of sync again
+                auto pickup = binding.pickup;
+                editedSet().knobListeners[index].back() = std::make_shared <ofEventListener>(param.newListener([this, pickup](float &){
+                    if(!bWritingKnobs){ // not our own write from update()
+                        pickup->dirty = true;
+                        if(pickup->rearm){
+                            pickup->armed = true;
+                        }
+                    }
+                }));
+            }
         }else{
             ofLogError() << "ofxLaunchControls: wrong indices for knob() function, binding ignored";
         }
     }
 }
 
-void ofxControllerBase::knob(int index, ofParameter <int> & param, int min, int max){
-    if(midiIn.isOpen()){
+void ofxControllerBase::knobTakeover(int index, ofParameter <int> & param, int min, int max, TakeoverMode mode, int tolerance, const ofxControllerCurve & curve){
+    if(isBindable()){
+        std::lock_guard <std::recursive_mutex> lock(bindingMutex);
+        auto & knobs = editedSet().knobs;
         if(index >= 0 && index < (int)knobs.size()){
-            knobs[index].emplace_back();
-            knobs[index].back().controlNum = knobsCC[index];
-            knobs[index].back().typeCode = LC_TYPECODE_INT;
-            knobs[index].back().pParami = &param;
-            knobs[index].back().maxi = max;
-            knobs[index].back().mini = min;
-            knobs[index].back().value = (float)param;
-            knobs[index].back().z1 = (float)param;
+            auto & binding = addKnobBinding(index);
+            binding.typeCode = LC_TYPECODE_INT;
+            binding.pParami = &param;
+            binding.maxi = max;
+            binding.mini = min;
+            curve.fill(binding.lut, min, max);
+            binding.value = (float)param;
+            binding.z1 = (float)param;
+            setupTakeover(binding, mode, tolerance);
+
+            if(mode != LC_TAKEOVER_JUMP){
+                // changed by the app, a preset or a gui: the control is out of sync again
+                auto pickup = binding.pickup;
+                editedSet().knobListeners[index].back() = std::make_shared <ofEventListener>(param.newListener([this, pickup](int &){
+                    if(!bWritingKnobs){ // not our own write from update()
+                        pickup->dirty = true;
+                        if(pickup->rearm){
+                            pickup->armed = true;
+                        }
+                    }
+                }));
+            }
         }else{
             ofLogError() << "ofxLaunchControls: wrong indices for knob() function, binding ignored";
         }
     }
 }
 
-void ofxControllerBase::knobPickup(int index, ofParameter <float> & param, float min, float max, int tolerance){
-    if(midiIn.isOpen()){
-        if(index >= 0 && index < (int)knobs.size()){
-            knobs[index].emplace_back();
-            knobs[index].back().controlNum = knobsCC[index];
-            knobs[index].back().typeCode = LC_TYPECODE_FLOAT;
-            knobs[index].back().pParamf = &param;
-            knobs[index].back().maxf = max;
-            knobs[index].back().minf = min;
-            knobs[index].back().value = param;
-            knobs[index].back().z1 = param;
-            knobs[index].back().pickupEnabled = true;
-            knobs[index].back().pickupArmed = true;
-            knobs[index].back().pickupTolerance = tolerance;
-        }else{
-            ofLogError() << "ofxLaunchControls: wrong indices for knobPickup() function, binding ignored";
+void ofxControllerBase::knobTakeover(int index, ofParameter <float> & param, TakeoverMode mode, int tolerance, const ofxControllerCurve & curve){
+    knobTakeover(index, param, param.getMin(), param.getMax(), mode, tolerance, curve);
+}
+
+void ofxControllerBase::knobTakeover(int index, ofParameter <int> & param, TakeoverMode mode, int tolerance, const ofxControllerCurve & curve){
+    knobTakeover(index, param, param.getMin(), param.getMax(), mode, tolerance, curve);
+}
+
+void ofxControllerBase::setupTakeover(Binding & binding, TakeoverMode mode, int tolerance){
+    binding.takeover = mode;
+    binding.pickup = std::make_shared <TakeoverFlags>();
+    binding.pickup->armed = mode != LC_TAKEOVER_JUMP;
+    binding.pickupTolerance = tolerance;
+    binding.pickupMidi = pickupPosition(binding);
+    binding.lastMidi = -1;
+}
+
+float ofxControllerBase::pickupPosition(const Binding & binding) const {
+    switch(binding.typeCode){
+     case LC_TYPECODE_FLOAT:
+         return binding.pParamf ? lutPosition(binding.lut, *(binding.pParamf)) : 0.0f;
+     case LC_TYPECODE_INT:
+         return binding.pParami ? lutPosition(binding.lut, (float)*(binding.pParami)) : 0.0f;
+     default:
+         return 0.0f;
+    }
+}
+
+ofxControllerBase::PickupStatus ofxControllerBase::getPickupStatus(int index) const {
+    PickupStatus status = { false, false, 0.0f };
+    if(active && index >= 0 && index < (int)active->knobs.size()){
+        for(auto & binding : active->knobs[index]){
+            if(binding.takeover != LC_TAKEOVER_JUMP && binding.pickup->armed){
+                float target = binding.pickup->dirty ? pickupPosition(binding) : binding.pickupMidi;
+                status.armed = true;
+                status.known = binding.lastMidi >= 0;
+                status.distance = status.known ? target - binding.lastMidi : 0.0f;
+                break;
+            }
         }
     }
+    return status;
 }
 
-void ofxControllerBase::knobPickup(int index, ofParameter <int> & param, int min, int max, int tolerance){
-    if(midiIn.isOpen()){
-        if(index >= 0 && index < (int)knobs.size()){
-            knobs[index].emplace_back();
-            knobs[index].back().controlNum = knobsCC[index];
-            knobs[index].back().typeCode = LC_TYPECODE_INT;
-            knobs[index].back().pParami = &param;
-            knobs[index].back().maxi = max;
-            knobs[index].back().mini = min;
-            knobs[index].back().value = (float)param;
-            knobs[index].back().z1 = (float)param;
-            knobs[index].back().pickupEnabled = true;
-            knobs[index].back().pickupArmed = true;
-            knobs[index].back().pickupTolerance = tolerance;
+std::string ofxControllerBase::getKnobName(int index) const {
+    if(active && index >= 0 && index < (int)active->knobs.size() && !active->knobs[index].empty()){
+        auto & binding = active->knobs[index].front();
+        switch(binding.typeCode){
+         case LC_TYPECODE_FLOAT:   return binding.pParamf ? binding.pParamf->getName() : "";
+         case LC_TYPECODE_INT:     return binding.pParami ? binding.pParami->getName() : "";
+         case LC_TYPECODE_VECTOR3: return binding.pParamv3 ? binding.pParamv3->getName() : "";
+         default: break;
+        }
+    }
+    return "";
+}
+
+bool ofxControllerBase::checkTakeover(Binding & binding, int midi){
+    float target = binding.pickupMidi;
+    float distance = (float)midi - target;
+    if(std::abs(distance) <= binding.pickupTolerance){
+        return true;
+    }
+
+    int last = binding.lastMidi;
+    switch(binding.takeover){
+     case LC_TAKEOVER_CROSSING:
+         // a fast move can jump over the tolerance window, pickup on the crossing
+         return last >= 0 && (last - target) * distance < 0.0f;
+
+     case LC_TAKEOVER_SCALING:
+         // move the value proportionally to the remaining travel, so that
+         // value and control converge at the end of the range
+         if(last >= 0 && midi != last){
+             float scaled;
+             if(midi > last){
+                 scaled = target + (midi - last) * (127.0f - target) / std::max(127 - last, 1);
+             }else{
+                 scaled = target - (last - midi) * target / std::max(last, 1);
+             }
+             scaled = ofClamp(scaled, 0.0f, 127.0f);
+             if(std::abs(midi - scaled) <= binding.pickupTolerance || (last - target) * (midi - scaled) < 0.0f){
+                 return true;
+             }
+             binding.pickupMidi = scaled;
+             binding.value = lutValue(binding.lut, scaled);
+             binding.bUpdate = true;
+         }
+         return false;
+
+     case LC_TAKEOVER_PICKUP:
+     default:
+         return false;
+    }
+}
+
+ofxControllerBase::ImmediateSlot::ImmediateSlot(){
+    generation = 0;
+    target = nullptr;
+    time = nullptr;
+    for(auto & v : lut){
+        v = 0.0f;
+    }
+}
+
+ofxControllerBase::ImmediateSlot::ImmediateSlot(const ImmediateSlot & other){
+    generation.store(other.generation);
+    target.store(other.target);
+    time.store(other.time);
+    for(int i = 0; i < ofxControllerCurve::tableSize; ++i){
+        lut[i].store(other.lut[i]);
+    }
+}
+
+void ofxControllerBase::knobImmediate(int index, std::atomic <float> & target, float min, float max, const ofxControllerCurve & curve){
+    bindImmediate(index, &target, nullptr, min, max, curve);
+}
+
+void ofxControllerBase::knobTap(int index, ofxControllerValueTap & tap, float min, float max, const ofxControllerCurve & curve){
+    bindImmediate(index, &tap.getTarget(), &tap.getTime(), min, max, curve);
+}
+
+void ofxControllerBase::bindImmediate(int index, std::atomic <float> * target, std::atomic <uint64_t> * time, float min, float max, const ofxControllerCurve & curve){
+    if(isBindable()){
+        if(index >= 0 && index < (int)immediates.size()){
+            float table[ofxControllerCurve::tableSize];
+            curve.fill(table, min, max);
+            // the binding lock keeps a single writer per slot, the odd generation
+            // makes the MIDI thread discard any read overlapping this update
+            std::lock_guard <std::recursive_mutex> lock(bindingMutex);
+            auto & slot = immediates[index];
+            uint32_t generation = slot.generation.load(std::memory_order_relaxed);
+            slot.generation.store(generation + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            for(int i = 0; i < ofxControllerCurve::tableSize; ++i){
+                slot.lut[i].store(table[i], std::memory_order_relaxed);
+            }
+            slot.time.store(time, std::memory_order_relaxed);
+            slot.target.store(target, std::memory_order_relaxed);
+            slot.generation.store(generation + 2, std::memory_order_release);
         }else{
-            ofLogError() << "ofxLaunchControls: wrong indices for knobPickup() function, binding ignored";
+            ofLogError() << "ofxLaunchControls: wrong indices for knobImmediate() function, binding ignored";
         }
     }
 }
 
-void ofxControllerBase::knobPickup(int index, ofParameter <float> & param, int tolerance){
-    knobPickup(index, param, param.getMin(), param.getMax(), tolerance);
+void ofxControllerBase::setInputChannels(uint16_t mask){
+    channelMask = mask;
+}
+
+void ofxControllerBase::setInputChannel(int channel, bool accept){
+    if(channel < 1 || channel > 16){
+        ofLogError() << "ofxLaunchControls: wrong channel for setInputChannel() function, ignored";
+        return;
+    }
+    uint16_t bit = 1 << (channel - 1);
+    if(accept){
+        channelMask.fetch_or(bit);
+    }else{
+        channelMask.fetch_and(~bit);
+    }
+}
+
+uint16_t ofxControllerBase::getInputChannels() const {
+    return channelMask;
+}
+
+void ofxControllerBase::setInputTypes(int types){
+    inputTypes = types;
+}
+
+int ofxControllerBase::getInputTypes() const {
+    return inputTypes;
+}
+
+uint64_t ofxControllerBase::getKnobTime(int index) const {
+    if(index >= 0 && index < (int)knobTimes.size()){
+        return knobTimes[index].load(std::memory_order_relaxed);
+    }
+    return 0;
+}
+
+uint64_t ofxControllerBase::getButtonTime(int index) const {
+    if(index >= 0 && index < (int)buttonTimes.size()){
+        return buttonTimes[index].load(std::memory_order_relaxed);
+    }
+    return 0;
+}
+
+void ofxControllerBase::clearKnobImmediate(int index){
+    if(index >= 0 && index < (int)immediates.size()){
+        std::lock_guard <std::recursive_mutex> lock(bindingMutex);
+        auto & slot = immediates[index];
+        uint32_t generation = slot.generation.load(std::memory_order_relaxed);
+        slot.generation.store(generation + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.target.store(nullptr, std::memory_order_relaxed);
+        slot.generation.store(generation + 2, std::memory_order_release);
+    }else{
+        ofLogError() << "ofxLaunchControls: wrong index in clearKnobImmediate() function, binding ignored";
+    }
+}
+
+void ofxControllerBase::knobPickup(int index, ofParameter <float> & param, float min, float max, int tolerance, const ofxControllerCurve & curve){
+    std::lock_guard <std::recursive_mutex> lock(bindingMutex);
+    knobTakeover(index, param, min, max, LC_TAKEOVER_PICKUP, tolerance, curve);
+    armOnce(index);
+}
+
+void ofxControllerBase::knobPickup(int index, ofParameter <int> & param, int min, int max, int tolerance, const ofxControllerCurve & curve){
+    std::lock_guard <std::recursive_mutex> lock(bindingMutex);
+    knobTakeover(index, param, min, max, LC_TAKEOVER_PICKUP, tolerance, curve);
+    armOnce(index);
+}
+
+void ofxControllerBase::armOnce(int index){
+    // knobTakeover() logged the error if it didn't bind
+    if(isBindable() && index >= 0 && index < (int)editedSet().knobs.size() && !editedSet().knobs[index].empty()){
+        editedSet().knobs[index].back().pickup->rearm = false;
+    }
+}
+
+void ofxControllerBase::knobPickup(int index, ofParameter <float> & param, int tolerance, const ofxControllerCurve & curve){
+    knobPickup(index, param, param.getMin(), param.getMax(), tolerance, curve);
 }
 
-void ofxControllerBase::knobPickup(int index, ofParameter <int> & param, int tolerance){
-    knobPickup(index, param, param.getMin(), param.getMax(), tolerance);
+void ofxControllerBase::knobPickup(int index, ofParameter <int> & param, int tolerance, const ofxControllerCurve & curve){
+    knobPickup(index, param, param.getMin(), param.getMax(), tolerance, curve);
 }
 
 void ofxControllerBase::knob3(int index, ofParameter <glm::vec3> & param, glm::vec3 min, glm::vec3 max){
-    if(midiIn.isOpen()){
+    if(isBindable()){
+        std::lock_guard <std::recursive_mutex> lock(bindingMutex);
+        auto & knobs = editedSet().knobs;
         if(index >= 0 && index < (int)knobs.size() - 2){
-            knobs[index].emplace_back();
-            knobs[index].back().controlNum = knobsCC[index];
+            addKnobBinding(index);
             knobs[index].back().typeCode = LC_TYPECODE_VECTOR3;
             knobs[index].back().pParamv3 = &param;
             knobs[index].back().maxv3 = max;
@@ -684,17 +1672,247 @@ void ofxControllerBase::knob3(int index, ofParameter <glm::vec3> & param, glm::v
 }
 
 
-void ofxControllerBase::knob(int index, ofParameter <float> & param){
-    knob(index, param, param.getMin(), param.getMax());
+void ofxControllerBase::knob(int index, ofParameter <float> & param, const ofxControllerCurve & curve){
+    knob(index, param, param.getMin(), param.getMax(), curve);
+}
+
+void ofxControllerBase::knob(int index, ofParameter <int> & param, const ofxControllerCurve & curve){
+    knob(index, param, param.getMin(), param.getMax(), curve);
+}
+
+void ofxControllerBase::encoder(int index, ofParameter <float> & param, float min, float max, float step, EncoderMode mode, float acceleration){
+    if(isBindable()){
+        std::lock_guard <std::recursive_mutex> lock(bindingMutex);
+        auto & knobs = editedSet().knobs;
+        if(index >= 0 && index < (int)knobs.size()){
+            auto & binding = addKnobBinding(index);
+            binding.typeCode = LC_TYPECODE_FLOAT;
+            binding.pParamf = &param;
+            binding.maxf = max;
+            binding.minf = min;
+            binding.value = param;
+            binding.z1 = param;
+            binding.relative = true;
+            binding.encoderMode = mode;
+            binding.encoderStep = step;
+            binding.encoderAcceleration = acceleration;
+        }else{
+            ofLogError() << "ofxLaunchControls: wrong indices for encoder() function, binding ignored";
+        }
+    }
+}
+
+void ofxControllerBase::encoder(int index, ofParameter <int> & param, int min, int max, float step, EncoderMode mode, float acceleration){
+    if(isBindable()){
+        std::lock_guard <std::recursive_mutex> lock(bindingMutex);
+        auto & knobs = editedSet().knobs;
+        if(index >= 0 && index < (int)knobs.size()){
+            auto & binding = addKnobBinding(index);
+            binding.typeCode = LC_TYPECODE_INT;
+            binding.pParami = &param;
+            binding.maxi = max;
+            binding.mini = min;
+            binding.value = (float)param;
+            binding.z1 = (float)param;
+            binding.relative = true;
+            binding.encoderMode = mode;
+            binding.encoderStep = step;
+            binding.encoderAcceleration = acceleration;
+        }else{
+            ofLogError() << "ofxLaunchControls: wrong indices for encoder() function, binding ignored";
+        }
+    }
+}
+
+void ofxControllerBase::encoder(int index, ofParameter <float> & param, EncoderMode mode, float acceleration){
+    encoder(index, param, param.getMin(), param.getMax(), (param.getMax() - param.getMin()) / 127.0f, mode, acceleration);
+}
+
+void ofxControllerBase::encoder(int index, ofParameter <int> & param, EncoderMode mode, float acceleration){
+    encoder(index, param, param.getMin(), param.getMax(), 1.0f, mode, acceleration);
+}
+
+void ofxControllerBase::encoderFine(bool enabled, float scale){
+    encoderScale = enabled ? scale : 1.0f;
+}
+
+bool ofxControllerBase::moveEncoder(Binding & binding, int midi, uint64_t time){
+    int delta = encoderDelta(midi, binding.encoderMode);
+    if(delta == 0){
+        return false;
+    }
+
+    float velocity = 1.0f;
+    if(binding.lastEventTime > 0 && time > binding.lastEventTime){
+        velocity = encoderVelocity(time - binding.lastEventTime, binding.encoderAcceleration);
+    }
+    binding.lastEventTime = time;
+
+    float min, max, current;
+    if(binding.typeCode == LC_TYPECODE_INT){
+        min = binding.mini;
+        max = binding.maxi;
+        current = (float)*(binding.pParami);
+        // keep the fractional steps, unless the parameter was changed elsewhere
+        if(!binding.bUpdate && (int)binding.value != (int)current){
+            binding.value = current;
+        }
+    }else{
+        min = binding.minf;
+        max = binding.maxf;
+        current = *(binding.pParamf);
+        if(!binding.bUpdate && binding.value != current){
+            binding.value = current;
+        }
+    }
+
+    float value = ofClamp(binding.value + delta * binding.encoderStep * velocity * encoderScale, std::min(min, max), std::max(min, max));
+    if(value == binding.value){
+        return false;
+    }
+    binding.value = value;
+    return true;
+}
+
+void ofxControllerBase::knobHiRes(int index, ofParameter <float> & param, float min, float max, int lsbControl, const ofxControllerCurve & curve){
+    knob(index, param, min, max, curve);
+    setHiRes(index, lsbControl);
+}
+
+void ofxControllerBase::knobHiRes(int index, ofParameter <int> & param, int min, int max, int lsbControl, const ofxControllerCurve & curve){
+    knob(index, param, min, max, curve);
+    setHiRes(index, lsbControl);
+}
+
+void ofxControllerBase::setHiRes(int index, int lsbControl){
+    std::lock_guard <std::recursive_mutex> lock(bindingMutex);
+    if(isBindable() && index >= 0 && index < (int)editedSet().knobs.size() && !editedSet().knobs[index].empty()){
+        auto & binding = editedSet().knobs[index].back();
+        binding.lsbControl = lsbControl >= 0 ? lsbControl : binding.controlNum + 32;
+        binding.msb = 0;
+    }
+}
+
+void ofxControllerBase::nrpn(int number, ofParameter <float> & param, float min, float max, const ofxControllerCurve & curve){
+    if(isBindable()){
+        if(number >= 0 && number < 16384){
+            std::lock_guard <std::recursive_mutex> lock(bindingMutex);
+            auto & nrpns = editedSet().nrpns;
+            nrpns.emplace_back();
+            nrpns.back().controlNum = number;
+            nrpns.back().typeCode = LC_TYPECODE_FLOAT;
+            nrpns.back().pParamf = &param;
+            nrpns.back().maxf = max;
+            nrpns.back().minf = min;
+            curve.fill(nrpns.back().lut, min, max);
+            nrpns.back().value = param;
+        }else{
+            ofLogError() << "ofxLaunchControls: wrong number for nrpn() function, binding ignored";
+        }
+    }
+}
+
+void ofxControllerBase::nrpn(int number, ofParameter <int> & param, int min, int max, const ofxControllerCurve & curve){
+    if(isBindable()){
+        if(number >= 0 && number < 16384){
+            std::lock_guard <std::recursive_mutex> lock(bindingMutex);
+            auto & nrpns = editedSet().nrpns;
+            nrpns.emplace_back();
+            nrpns.back().controlNum = number;
+            nrpns.back().typeCode = LC_TYPECODE_INT;
+            nrpns.back().pParami = &param;
+            nrpns.back().maxi = max;
+            nrpns.back().mini = min;
+            curve.fill(nrpns.back().lut, min, max);
+            nrpns.back().value = (float)param;
+        }else{
+            ofLogError() << "ofxLaunchControls: wrong number for nrpn() function, binding ignored";
+        }
+    }
+}
+
+bool ofxControllerBase::processNrpn(const ofxMidiMessage & msg, bool & dirty){
+    if(msg.channel < 1 || msg.channel > 16 || msg.control < 0 || msg.control >= int(knobIndexForCC.size())){
+        return false;
+    }
+    int & number = nrpnNumber[msg.channel - 1];
+    int & msb = nrpnMsb[msg.channel - 1];
+
+    // a knob bound on the same cc keeps it, e.g. the XL fader on cc 6
+    int knob = knobIndexForCC[msg.control];
+    bool bound = knob >= 0 && !active->knobs[knob].empty();
+
+    int value = msg.value & 0x7F;
+    float position; // in the lookup table
+    switch(msg.control){
+     case 99:   // number msb
+         if(bound){
+             return false;
+         }
+         number = value << 7;
+         return true;
+
+     case 98:   // number lsb
+         if(bound){
+             return false;
+         }
+         number = (number < 0 ? 0 : number & 0x3F80) | value;
+         if(number == 0x3FFF){
+             number = -1; // null number, the data that follows is not ours
+         }
+         return true;
+
+     case 101:  // rpn select, the data that follows is not ours
+     case 100:
+         number = -1;
+         return false;
+
+     case 6:    // data msb, applies at once as a 7 bit value
+         if(number < 0 || bound){
+             return false;
+         }
+         msb = value;
+         position = value;
+         break;
+
+     case 38:   // data lsb, refines the last msb to the full 14 bit range
+         if(number < 0 || bound){
+             return false;
+         }
+         position = ((msb << 7) | value) * (127.0f / 16383.0f);
+         break;
+
+     default:
+         return false;
+    }
+
+    for(auto & binding : active->nrpns){
+        if(binding.controlNum == number){
+            binding.value = lutValue(binding.lut, position);
+            binding.bUpdate = true;
+            dirty = true;
+        }
+    }
+    return true;
 }
 
-void ofxControllerBase::knob(int index, ofParameter <int> & param){
-    knob(index, param, param.getMin(), param.getMax());
+void ofxControllerBase::knobDeadband(int index, int steps){
+    std::lock_guard <std::recursive_mutex> lock(bindingMutex);
+    if(!staged.empty() && index >= 0 && index < (int)editedSet().knobs.size()){
+        for(auto & binding : editedSet().knobs[index]){
+            binding.deadband = std::max(steps, 0);
+            binding.acceptedMidi = -1;
+        }
+    }else{
+        ofLogError() << "ofxLaunchControls: wrong index in knobDeadband() function, ignored";
+    }
 }
 
 void ofxControllerBase::clearKnob(int index){
-    if(index >= 0 && index < (int)knobs.size()){
-        knobs[index].clear();
+    std::lock_guard <std::recursive_mutex> lock(bindingMutex);
+    if(!staged.empty() && index >= 0 && index < (int)editedSet().knobs.size()){
+        editedSet().knobs[index].clear();
+        editedSet().knobListeners[index].clear();
     }else{
         ofLogError() << "ofxLaunchControls: wrong index in clearKnob() function, binding ignored";
     }
@@ -740,32 +1958,216 @@ void ofxControllerBase::toggle(int index, ofParameter <int> & param){
 }
 
 void ofxControllerBase::toggleButton(int controlId, ofParameter <bool> & param){
-    if(midiIn.isOpen()){
+    if(isBindable()){
+        std::lock_guard <std::recursive_mutex> lock(bindingMutex);
+        auto & ccButtons = editedSet().ccButtons;
         ccButtons.emplace_back();
         ccButtons.back().controlNum = controlId;
         ccButtons.back().typeCode = LC_TYPECODE_BOOL;
         ccButtons.back().pParamb = &param;
         ccButtons.back().bActive = param.get();
         ccButtons.back().bUpdate = false;
+    }
+}
 
-        param.addListener(this, &ofxControllerBase::buttonChangedB);
+void ofxControllerBase::onButton(int index, ButtonEvent event, ofxControllerCallback callback, CallbackContext context){
+    if(index >= 0 && index < (int)buttonsNote.size()){
+        addCallback(index, event, callback, context);
+    }else{
+        ofLogError() << "ofxLaunchControls: wrong index for onButton() function, binding ignored";
     }
 }
 
-void ofxControllerBase::radioChanged(int & value){
-    bUpdate = true;
+void ofxControllerBase::onControl(int controlId, ButtonEvent event, ofxControllerCallback callback, CallbackContext context){
+    if(controlId >= 0 && controlId < 128){
+        addCallback(buttonsNote.size() + controlId, event, callback, context);
+    }else{
+        ofLogError() << "ofxLaunchControls: wrong cc for onControl() function, binding ignored";
+    }
 }
 
-void ofxControllerBase::buttonChangedB(bool & value){
-    bUpdate = true;
+void ofxControllerBase::addCallback(int source, ButtonEvent event, const ofxControllerCallback & callback, CallbackContext context){
+    if(!isBindable()){
+        return;
+    }
+    if(context != LC_CALLBACK_MIDI){
+        std::lock_guard <std::recursive_mutex> lock(bindingMutex);
+        editedSet().callbacks.push_back({ source, event, context, callback });
+        return;
+    }
+    if(event != LC_BUTTON_PRESS && event != LC_BUTTON_RELEASE){
+        ofLogError() << "ofxLaunchControls: gesture callbacks can't run on the MIDI thread, binding ignored";
+        return;
+    }
+
+    auto & slot = midiCallbacks[source * 2 + (event == LC_BUTTON_PRESS ? 0 : 1)];
+    slot.armed = false;
+    while(slot.busy > 0){
+        std::this_thread::yield(); // a call in progress still uses the old callback
+    }
+    slot.callback = callback;
+    slot.armed = true;
+    midiCallbacksBound = true;
 }
 
-void ofxControllerBase::buttonChangedI(int & value){
-    bUpdate = true;
+void ofxControllerBase::clearCallbacks(){
+    {
+        std::lock_guard <std::recursive_mutex> lock(bindingMutex);
+        if(!staged.empty()){
+            editedSet().callbacks.clear();
+        }
+    }
+    for(size_t i = 0; i < numMidiCallbacks; ++i){
+        auto & slot = midiCallbacks[i];
+        slot.armed = false;
+        while(slot.busy > 0){
+            std::this_thread::yield();
+        }
+        slot.callback.reset();
+    }
+    midiCallbacksBound = false;
 }
 
-void ofxControllerBase::buttonChangedF(float & value){
-    bUpdate = true;
+void ofxControllerBase::setLongPressTime(float seconds){
+    longPressTime = uint64_t(std::max(seconds, 0.0f) * 1000000000.0);
+}
+
+void ofxControllerBase::setDoubleTapTime(float seconds){
+    doubleTapTime = uint64_t(std::max(seconds, 0.0f) * 1000000000.0);
+}
+
+void ofxControllerBase::setRepeatTime(float seconds){
+    repeatTime = uint64_t(std::max(seconds, 0.001f) * 1000000000.0);
+}
+
+int ofxControllerBase::callbackSource(const ofxMidiMessage & msg, bool & pressed) const {
+    if(msg.status == MIDI_CONTROL_CHANGE && msg.control >= 0 && msg.control < 128){
+        pressed = msg.value > 64;
+        return buttonsNote.size() + msg.control;
+    }
+    if((msg.status == MIDI_NOTE_ON || msg.status == MIDI_NOTE_OFF) && msg.pitch >= 0 && msg.pitch < int(buttonIndexForNote.size())){
+        pressed = msg.status == MIDI_NOTE_ON && msg.velocity > 0;
+        return buttonIndexForNote[msg.pitch];
+    }
+    return -1;
+}
+
+void ofxControllerBase::fireCallbacks(int source, ButtonEvent event){
+    auto & callbacks = active->callbacks;
+    for(size_t i = 0; i < callbacks.size(); ++i){
+        if(callbacks[i].source == source && callbacks[i].event == event){
+            if(callbacks[i].context == LC_CALLBACK_CONTROLLER){
+                callbacks[i].callback();
+            }else if(pendingCallbacks.size() < pendingCallbacks.capacity()){
+                pendingCallbacks.emplace_back(active, i);
+            }else{
+                ofLogWarning() << "ofxLaunchControls: too many button callbacks in one update, callback dropped";
+            }
+        }
+    }
+}
+
+void ofxControllerBase::runCallbacks(){
+    for(auto & pending : pendingCallbacks){
+        auto & callbacks = pending.first->callbacks;
+        if(pending.second < callbacks.size()){
+            callbacks[pending.second].callback();
+        }
+    }
+    pendingCallbacks.clear();
+}
+
+bool ofxControllerBase::hasCallback(int source, ButtonEvent event) const {
+    for(auto & callback : active->callbacks){
+        if(callback.source == source && callback.event == event){
+            return true;
+        }
+    }
+    return false;
+}
+
+void ofxControllerBase::gesturePress(int source, uint64_t time){
+    auto & phase = gestures[source];
+    if(phase != LC_GESTURE_IDLE && phase != LC_GESTURE_WAIT_SECOND){
+        return; // still down, e.g. a cc button sending more values over 64
+    }
+    fireCallbacks(source, LC_BUTTON_PRESS);
+
+    if(phase == LC_GESTURE_WAIT_SECOND){
+        gestureTimers.cancel(source);
+        phase = LC_GESTURE_SECOND_DOWN;
+        fireCallbacks(source, LC_BUTTON_DOUBLE_TAP);
+    }else{
+        phase = LC_GESTURE_DOWN;
+        gestureTimers.schedule(source, time + longPressTime);
+    }
+}
+
+void ofxControllerBase::gestureRelease(int source, uint64_t time){
+    auto & phase = gestures[source];
+    if(phase == LC_GESTURE_IDLE || phase == LC_GESTURE_WAIT_SECOND){
+        return;
+    }
+    fireCallbacks(source, LC_BUTTON_RELEASE);
+
+    if(phase == LC_GESTURE_DOWN && hasCallback(source, LC_BUTTON_DOUBLE_TAP)){
+        // the tap waits, it could still become a double tap
+        phase = LC_GESTURE_WAIT_SECOND;
+        gestureTimers.schedule(source, time + doubleTapTime);
+        return;
+    }
+    if(phase == LC_GESTURE_DOWN){
+        fireCallbacks(source, LC_BUTTON_TAP);
+    }
+    gestureTimers.cancel(source);
+    phase = LC_GESTURE_IDLE;
+}
+
+void ofxControllerBase::gestureTimeout(int source, uint64_t now){
+    auto & phase = gestures[source];
+    switch(phase){
+     case LC_GESTURE_DOWN:
+         phase = LC_GESTURE_HELD;
+         fireCallbacks(source, LC_BUTTON_LONG_PRESS);
+         if(hasCallback(source, LC_BUTTON_REPEAT)){
+             gestureTimers.schedule(source, now + repeatTime);
+         }
+         break;
+
+     case LC_GESTURE_HELD:
+         fireCallbacks(source, LC_BUTTON_REPEAT);
+         gestureTimers.schedule(source, now + repeatTime);
+         break;
+
+     case LC_GESTURE_WAIT_SECOND:
+         phase = LC_GESTURE_IDLE;
+         fireCallbacks(source, LC_BUTTON_TAP);
+         break;
+
+     default:
+         break;
+    }
+}
+
+ofxControllerBase::MidiCallbackSlot::MidiCallbackSlot(){
+    armed = false;
+    busy = 0;
+}
+
+void ofxControllerBase::markLed(int index){
+    if(index >= 0 && index < (int)numLeds){
+        ledDirty[index] = true;
+        bLedsDirty = true;
+    }
+}
+
+void ofxControllerBase::flushLeds(){
+    bLedsDirty = false;
+    for(size_t b = 0; b < numLeds; ++b){
+        if(ledDirty[b].exchange(false)){
+            refreshLed(b);
+        }
+    }
 }
 
 void ofxControllerBase::enableEasing(float speed){
@@ -786,97 +2188,349 @@ void ofxControllerBase::easing(float speed){
 }
 
 
-void ofxControllerBase::removeParameterListeners(){
-    std::unordered_set<ofParameter<bool>*> boolParams;
-    std::unordered_set<ofParameter<float>*> floatParams;
-    std::unordered_set<ofParameter<int>*> intParams;
-
-    for(auto & b : buttons){
-        switch(b.typeCode){
-            case LC_TYPECODE_BOOL:
-                if(b.pParamb) boolParams.insert(b.pParamb);
-                break;
-            case LC_TYPECODE_FLOAT:
-                if(b.pParamf) floatParams.insert(b.pParamf);
-                break;
-            case LC_TYPECODE_INT:
-                if(b.pParami) intParams.insert(b.pParami);
-                break;
-            default:
-                break;
+std::unique_ptr <ofxControllerBase::BindingSet> ofxControllerBase::makePage(const std::string & pageName) const {
+    auto page = std::make_unique <BindingSet>();
+    page->name = pageName;
+    page->buttons.resize(buttonsNote.size());
+    page->buttonListeners.resize(buttonsNote.size());
+    for(size_t b = 0; b < buttonsNote.size(); ++b){
+        page->buttons[b].controlNum = buttonsNote[b];
+    }
+    page->knobs.resize(knobsCC.size());
+    page->knobListeners.resize(knobsCC.size());
+    return page;
+}
+
+int ofxControllerBase::findPage(const std::string & pageName) const {
+    for(size_t i = 0; i < pages.size(); ++i){
+        if(pages[i]->name == pageName){
+            return i;
         }
     }
+    return -1;
+}
 
-    for(auto & b : ccButtons){
-        if(b.typeCode == LC_TYPECODE_BOOL && b.pParamb) boolParams.insert(b.pParamb);
+int ofxControllerBase::addPage(const std::string & pageName){
+    if(pages.empty()){
+        ofLogError() << "ofxLaunchControls: addPage() called before setup(), page ignored";
+        return -1;
     }
+    int page = findPage(pageName);
+    if(page < 0){
+        // the active page keeps its address, nothing to do on the dispatch side
+        std::lock_guard <std::recursive_mutex> lock(bindingMutex);
+        pages.push_back(makePage(pageName));
+        staged.push_back(makePage(pageName));
+        stagedChanged.push_back(0);
+        page = pages.size() - 1;
+    }
+    editPage(page);
+    return page;
+}
 
-    for(auto & r : radios){
-        if(r.pParami) intParams.insert(r.pParami);
+void ofxControllerBase::editPage(int page){
+    if(page >= 0 && page < (int)pages.size()){
+        std::lock_guard <std::recursive_mutex> lock(bindingMutex);
+        editedPage = page;
+    }else{
+        ofLogError() << "ofxLaunchControls: wrong index for editPage() function, ignored";
     }
+}
+
+void ofxControllerBase::editPage(const std::string & pageName){
+    editPage(findPage(pageName));
+}
 
-    for(auto * p : boolParams){
-        p->removeListener(this, &ofxControllerBase::buttonChangedB);
+void ofxControllerBase::setPage(int page){
+    if(page < 0 || page >= (int)pages.size()){
+        ofLogError() << "ofxLaunchControls: wrong index for setPage() function, ignored";
+        return;
     }
-    for(auto * p : floatParams){
-        p->removeListener(this, &ofxControllerBase::buttonChangedF);
+    basePage = page;
+    if(heldModifier < 0){
+        switchPage(page);
+    }else{
+        for(size_t b = 0; b < pageForButton.size(); ++b){
+            if(pageForButton[b] >= 0){
+                markLed(b);
+            }
+        }
     }
-    for(auto * p : intParams){
-        // `int` params can be button-bound or radio-bound.
-        p->removeListener(this, &ofxControllerBase::buttonChangedI);
-        p->removeListener(this, &ofxControllerBase::radioChanged);
+}
+
+void ofxControllerBase::switchPage(int page){
+    if(page == activePage){
+        return;
+    }
+
+    // pending values still belong to the page that received them
+    if(bUpdate){
+        bUpdate = false;
+        writeBindings(*active);
     }
+
+    BindingSet & next = *pages[page];
+    resyncKnobs(next);
+
+    // buttons unused on the new page go dark, the bound ones refresh on update
+    if(buttonLedsEnabled){
+        for(size_t b = 0; b < next.buttons.size(); ++b){
+            if(next.buttons[b].typeCode == LC_TYPECODE_UNASSIGNED && pageForButton[b] < 0){
+                sendLed(buttonsNote[b], ofxLCLeds::Off);
+            }
+        }
+    }
+
+    active = &next;
+    activePage = page;
+    bUpdate = true;
+    bRefreshLeds = true;
+
+    onPageChanged(page);
 }
 
-void ofxControllerBase::clearBindings(){
-    // Keep the fixed MIDI mapping (controlNum / knobsCC), clear only bindings.
-    for(auto & b : buttons){
-        b.typeCode = LC_TYPECODE_UNASSIGNED;
-        b.bUpdate.store(false);
-        b.buttonMode = 0;
+void ofxControllerBase::resyncKnobs(BindingSet & page){
+    for(size_t i = 0; i < page.knobs.size(); ++i){
+        resyncKnob(page, i);
+    }
+}
 
-        b.pParamv3 = nullptr;
-        b.pParamf = nullptr;
-        b.pParami = nullptr;
-        b.pParamb = nullptr;
-        b.buttonListener = nullptr;
+void ofxControllerBase::resyncKnob(BindingSet & page, size_t i){
+    // the control stayed where the previous set left it
+    int midi = -1;
+    if(i < knobTimes.size() && knobTimes[i] > 0 && i < (size_t)ofxControllerState::maxKnobs){
+        midi = state.knobs[i];
+    }
+    for(auto & binding : page.knobs[i]){
+        binding.lastMidi = midi;
+        binding.acceptedMidi = -1;
+        if(binding.takeover != LC_TAKEOVER_JUMP){
+            binding.pickup->dirty = true;
+            binding.pickup->armed = true;
+        }
+        // easing starts from the parameter, not from a stale value
+        if(binding.typeCode == LC_TYPECODE_FLOAT && binding.pParamf){
+            binding.value = binding.z1 = *(binding.pParamf);
+            binding.bUpdate = false;
+        }else if(binding.typeCode == LC_TYPECODE_INT && binding.pParami){
+            binding.value = binding.z1 = (float)*(binding.pParami);
+            binding.bUpdate = false;
+        }
+    }
+}
 
-        b.value.store(0.0f);
-        b.values[0].store(0.0f);
-        b.values[1].store(0.0f);
-        b.values[2].store(0.0f);
+ofxControllerBase::BindingSet & ofxControllerBase::editedSet(){
+    stagedChanged[editedPage] = 1;
+    bStagedChanged = true;
+    return *staged[editedPage];
+}
 
-        b.pickupEnabled = false;
-        b.pickupArmed = false;
-        b.pickupTolerance = 2;
+void ofxControllerBase::publishBindings(){
+    // another thread is binding: no waiting here, the next update publishes
+    std::unique_lock <std::recursive_mutex> lock(bindingMutex, std::try_to_lock);
+    if(!lock.owns_lock()){
+        return;
+    }
+    bStagedChanged = false;
+    for(size_t i = 0; i < pages.size(); ++i){
+        if(!stagedChanged[i]){
+            continue;
+        }
+        stagedChanged[i] = 0;
 
-        b.bActive.store(false);
+        auto next = std::make_unique <BindingSet>(*staged[i]);
+        bool isActive = pages[i].get() == active;
+        carryBindings(*next, *pages[i], isActive);
+        if(isActive){
+            active = next.get();
+        }
+        pages[i] = std::move(next);
+    }
+}
 
+void ofxControllerBase::carryBindings(BindingSet & next, const BindingSet & live, bool isActive){
+    // the staged bindings never see any message, the live ones hold toggle and
+    // radio states, pending values, easing, encoder timing and 14 bit msb
+    for(size_t b = 0; b < next.buttons.size(); ++b){
+        if(b < live.buttons.size() && next.buttons[b].sameAs(live.buttons[b])){
+            next.buttons[b].carryState(live.buttons[b]);
+        }else if(isActive){
+            markLed(b);
+        }
+    }
 
-        b.minf = 0.0f;
-        b.maxf = 0.0f;
-        b.mini = 0;
-        b.maxi = 0;
-        b.minv3 = glm::vec3(0.0f);
-        b.maxv3 = glm::vec3(0.0f);
+    for(size_t i = 0; i < next.knobs.size(); ++i){
+        auto & bindings = next.knobs[i];
+        bool same = i < live.knobs.size() && bindings.size() == live.knobs[i].size();
+        for(size_t k = 0; same && k < bindings.size(); ++k){
+            same = bindings[k].sameAs(live.knobs[i][k]);
+        }
+        if(same){
+            for(size_t k = 0; k < bindings.size(); ++k){
+                bindings[k].carryState(live.knobs[i][k]);
+            }
+        }else{
+            resyncKnob(next, i); // only the changed knobs re-arm
+        }
+    }
 
-        b.radioGroup = -1;
-        b.radioValue = -1;
+    auto carryList = [](vector <Binding> & bindings, const vector <Binding> & liveBindings){
+        for(size_t k = 0; k < bindings.size() && k < liveBindings.size(); ++k){
+            if(bindings[k].sameAs(liveBindings[k])){
+                bindings[k].carryState(liveBindings[k]);
+            }
+        }
+    };
+    carryList(next.ccButtons, live.ccButtons);
+    carryList(next.nrpns, live.nrpns);
+
+    for(int g = 0; g < next.numRadios; ++g){
+        auto & radio = next.radios[g];
+        bool same = g < live.numRadios && radio.pParami == live.radios[g].pParami
+                    && radio.min == live.radios[g].min && radio.max == live.radios[g].max;
+        if(same){
+            radio.value.store(live.radios[g].value);
+            radio.bUpdate.store(live.radios[g].bUpdate);
+        }
+        if(isActive && (!same || radio.color != live.radios[g].color || radio.offColor != live.radios[g].offColor)){
+            for(int b = radio.min; b <= radio.max; ++b){
+                markLed(b);
+            }
+        }
+    }
+}
 
-        b.z1 = 0.0f;
-        b.z3 = glm::vec3(0.0f);
+void ofxControllerBase::setPage(const std::string & pageName){
+    int page = findPage(pageName);
+    if(page < 0){
+        ofLogError() << "ofxLaunchControls: no page named " << pageName << " for setPage() function, ignored";
+        return;
     }
+    setPage(page);
+}
+
+int ofxControllerBase::getPage() const {
+    return activePage;
+}
 
-    ccButtons.clear();
+int ofxControllerBase::getNumPages() const {
+    return pages.size();
+}
 
-    for(auto & k : knobs){
-        k.clear();
+std::string ofxControllerBase::getPageName(int page) const {
+    if(page >= 0 && page < (int)pages.size()){
+        return pages[page]->name;
     }
+    return "";
+}
+
+void ofxControllerBase::modifierButton(int index, int page){
+    if(index >= 0 && index < (int)buttonsNote.size() && page >= 0 && page < (int)pages.size()){
+        modifiers.push_back({ MIDI_NOTE_ON, buttonsNote[index], 0, page });
+    }else{
+        ofLogError() << "ofxLaunchControls: wrong indices for modifierButton() function, binding ignored";
+    }
+}
+
+void ofxControllerBase::modifierCC(int control, int page, int channel){
+    if(control >= 0 && control < 128 && page >= 0 && page < (int)pages.size()){
+        modifiers.push_back({ MIDI_CONTROL_CHANGE, control, channel, page });
+        if(channel > 0){
+            setInputChannel(channel);
+        }
+    }else{
+        ofLogError() << "ofxLaunchControls: wrong indices for modifierCC() function, binding ignored";
+    }
+}
+
+bool ofxControllerBase::isModifierHeld() const {
+    return heldModifier >= 0;
+}
 
-    radios.clear();
+bool ofxControllerBase::processModifier(const ofxMidiMessage & msg){
+    bool note = msg.status == MIDI_NOTE_ON || msg.status == MIDI_NOTE_OFF;
+    if(!note && msg.status != MIDI_CONTROL_CHANGE){
+        return false;
+    }
+    int number = note ? msg.pitch : msg.control;
+
+    for(size_t m = 0; m < modifiers.size(); ++m){
+        auto & modifier = modifiers[m];
+        if(modifier.number != number || (modifier.status == MIDI_NOTE_ON) != note
+           || (modifier.channel > 0 && modifier.channel != msg.channel)){
+            continue;
+        }
+        bool down = note ? (msg.status == MIDI_NOTE_ON && msg.velocity > 0) : msg.value > 64;
+        if(down){
+            heldModifier = m;
+            switchPage(modifier.page);
+        }else if(heldModifier == (int)m){
+            heldModifier = -1;
+            switchPage(basePage);
+        }
+        return true;
+    }
+    return false;
+}
+
+void ofxControllerBase::pageButton(int index, int page){
+    if(index >= 0 && index < (int)pageForButton.size() && page >= 0 && page < (int)pages.size()){
+        pageForButton[index] = page;
+        markLed(index);
+    }else{
+        ofLogError() << "ofxLaunchControls: wrong indices for pageButton() function, binding ignored";
+    }
+}
+
+void ofxControllerBase::removeParameterListeners(){
+    // the listeners are handles, dropping them unsubscribes
+    std::lock_guard <std::recursive_mutex> lock(bindingMutex);
+    for(auto * sets : { &pages, &staged }){
+        for(auto & page : *sets){
+            page->buttonListeners.assign(page->buttonListeners.size(), nullptr);
+            for(auto & listener : page->radioListeners){
+                listener = nullptr;
+            }
+            for(auto & listeners : page->knobListeners){
+                listeners.clear();
+            }
+        }
+    }
+}
+
+void ofxControllerBase::clearBindings(){
+    // Keep the fixed MIDI mapping (buttonsNote / knobsCC), drop all pages,
+    // setup() starts again from an empty default page.
+    std::lock_guard <std::recursive_mutex> lock(bindingMutex);
+    active = nullptr;
+    activePage = 0;
+    editedPage = 0;
+    basePage = 0;
+    heldModifier = -1;
+    pages.clear();
+    staged.clear();
+    stagedChanged.clear();
+    bStagedChanged = false;
+    pageForButton.assign(pageForButton.size(), -1);
+    modifiers.clear();
+    pendingCallbacks.clear();
+    gestures.assign(gestures.size(), LC_GESTURE_IDLE);
+    gestureTimers.cancelAll();
+
+    // the MIDI input is closed already, no call can be in progress
+    for(size_t i = 0; i < numMidiCallbacks; ++i){
+        midiCallbacks[i].armed = false;
+        midiCallbacks[i].callback.reset();
+    }
+    midiCallbacksBound = false;
+
+    for(auto & slot : immediates){
+        slot.target.store(nullptr, std::memory_order_release);
+    }
 }
 
 void ofxControllerBase::shutdown(){
+    disableReconnect();
     int prio = 0; // OF_EVENT_PRIORITY_BEFORE_APP
     ofRemoveListener(ofEvents().update, this, &ofxControllerBase::update, prio);
 
@@ -888,11 +2542,15 @@ void ofxControllerBase::shutdown(){
 
     clearLeds();
     leds.closePort();
+    inPortName.clear();
+    outPortName.clear();
+    bConnected = false;
 
     bUpdate = false;
     written = 0;
     lastRead = 0;
 
+    stopSharedState();
     clearBindings();
 }
 
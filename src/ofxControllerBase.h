@@ -3,17 +3,38 @@
 
 #include "ofMain.h"
 #include "ofxLCLeds.h"
+#include "ofxControllerValueTap.h"
+#include "ofxControllerCallback.h"
+#include "ofxControllerTimerWheel.h"
+#include "ofxControllerCurve.h"
+#include "ofxControllerEvents.h"
+#include "ofxControllerClock.h"
+#include "ofxControllerState.h"
+#include "ofxControllerSharedState.h"
+#include "ofxControllerStats.h"
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 // class for easily mapping with Novation Nocturn protocol
 // uses the first fixed presets, that defaults to midi channel 9
 // other template presets have the same cc and notes with different channels
 
+class ofxControllerManager;
+class ofxControllerSurface;
+
 class ofxControllerBase : public ofxMidiListener {
+  friend class ofxControllerManager;
+  friend class ofxControllerSurface;
   
 private:
   struct Binding;
   struct RadioGroup;
+  struct ImmediateSlot;
+  struct BindingSet;
+  struct MidiCallbackSlot;
+  struct EventSubscriber;
   
 public:
   ofxControllerBase();
@@ -27,15 +48,93 @@ public:
     LC_TYPECODE_RADIO = 4,
     LC_TYPECODE_VECTOR3 = 5
   };
+
+  // What a knob does when the physical control and the parameter disagree,
+  // e.g. after a preset change or a gui edit.
+  enum TakeoverMode {
+    LC_TAKEOVER_JUMP = 0,     // the parameter jumps to the control
+    LC_TAKEOVER_PICKUP = 1,   // ignored until the control is within tolerance
+    LC_TAKEOVER_SCALING = 2,  // the parameter moves proportionally until both converge
+    LC_TAKEOVER_CROSSING = 3  // like pickup, but also picks up when a fast move skips over the value
+  };
+  
+  // Relative value encodings of endless encoders.
+  enum EncoderMode {
+    LC_ENCODER_OFFSET_64 = 0,        // 64 + delta
+    LC_ENCODER_TWOS_COMPLEMENT = 1,  // 1..63 up, 127..65 down
+    LC_ENCODER_SIGN_BIT = 2          // 1..63 up, 65..127 down
+  };
+
+  // Button events for onButton() / onControl(). Gestures are timed from the
+  // message arrival times, only press and release can run on the MIDI thread.
+  enum ButtonEvent {
+    LC_BUTTON_PRESS = 0,
+    LC_BUTTON_RELEASE = 1,
+    LC_BUTTON_LONG_PRESS = 2,  // held for setLongPressTime()
+    LC_BUTTON_TAP = 3,         // released before a long press, delayed by the double tap time if there is a double tap callback
+    LC_BUTTON_DOUBLE_TAP = 4,  // pressed again within setDoubleTapTime() of a tap
+    LC_BUTTON_REPEAT = 5       // every setRepeatTime() while held after a long press
+  };
+
+  // Where a callback runs.
+  enum CallbackContext {
+    LC_CALLBACK_UPDATE = 0,      // end of update(), after the parameters were written
+    LC_CALLBACK_CONTROLLER = 1,  // while update() drains the buffer, in message order
+    LC_CALLBACK_MIDI = 2         // on the MIDI thread on arrival, keep it short and thread safe
+  };
+
+  // Message types accepted on arrival, see setInputTypes().
+  // System messages (clock, active sensing, sysex) are always dropped.
+  enum InputType {
+    LC_INPUT_NOTES = 1 << 0,
+    LC_INPUT_CC = 1 << 1,
+    LC_INPUT_PROGRAM = 1 << 2,
+    LC_INPUT_PITCHBEND = 1 << 3,
+    LC_INPUT_AFTERTOUCH = 1 << 4  // channel and poly
+  };
   
   void listDevices();
+
+  // The bindings, callbacks and leds use `channel`, the one of the template
+  // in use (9 is the first factory template). Messages on other channels are
+  // dropped on arrival, set the channel of your user template here.
+  // The port can also be given by name, then the controller can be set up
+  // and bound while the device is missing and enableReconnect() opens it
+  // when it is plugged in.
   bool setup(int port, int channel = 9);
+  bool setup(const std::string & portName, int channel = 9);
+
+  // Watches the ports on a background thread: when the device disappears its
+  // ports are closed, when it comes back they are reopened by name, takeover
+  // bindings re-arm and the leds are sent again. Bindings made meanwhile are
+  // kept. update() never waits for the reconnect thread.
+  void enableReconnect(float intervalSeconds = 1.0f);
+  void disableReconnect();
+  bool isConnected() const;
+
+  // The output ports may be reopened by the reconnect thread at any time:
+  // hold this lock while sending to them outside of the bindings (e.g. with
+  // ofxLaunchControlXL::getLeds()), skip the send if it isn't owned.
+  std::unique_lock <std::recursive_mutex> tryLockPorts();
 
   // Fully unregisters all listeners and clears bindings.
   // Safe to call before re-binding, or from the destructor.
   void shutdown();
+
+  // Messages on channels outside the mask are dropped on arrival, before the
+  // buffer. setup() accepts only its channel, modifierCC() adds its own.
+  // Other accepted channels only reach modifiers and subscribe() queues, the
+  // bindings always respond to the setup() channel alone.
+  // Bit n - 1 is channel n, 0xFFFF accepts everything.
+  void setInputChannels(uint16_t mask);
+  void setInputChannel(int channel, bool accept = true);
+  uint16_t getInputChannels() const;
+
+  // InputType flags, notes and cc by default.
+  void setInputTypes(int types);
+  int getInputTypes() const;
   
-  void button(int index, std::function<void()> buttonListener);
+  void button(int index, std::function<void()> buttonListener); // same as onButton(index, LC_BUTTON_PRESS, ...)
   void button(int index, ofParameter <bool> & param, bool momentary = false);
   void button(int index, ofParameter <float> & param, float min, float max, bool momentary = false);
   void button(int index, ofParameter <int> & param, int min, int max, bool momentary = false);
@@ -55,23 +154,122 @@ public:
 
   // MIDI CC "button" mapping: value > 64 => true.
   void toggleButton(int controlId, ofParameter <bool> & param);
+
+  // Callbacks for a button index, or a cc button (value > 64 is pressed).
+  // Callables are stored inline, see ofxControllerCallback, so nothing allocates
+  // when a button fires. Update and controller callbacks belong to the edited
+  // page, MIDI thread callbacks work on every page and have no long press.
+  // Don't add or clear callbacks from inside a callback.
+  void onButton(int index, ButtonEvent event, ofxControllerCallback callback, CallbackContext context = LC_CALLBACK_UPDATE);
+  void onControl(int controlId, ButtonEvent event, ofxControllerCallback callback, CallbackContext context = LC_CALLBACK_UPDATE);
+  void clearCallbacks(); // of the edited page and the MIDI thread
+  void setLongPressTime(float seconds);
+  void setDoubleTapTime(float seconds);
+  void setRepeatTime(float seconds);
   
+  // buttons indexMin..indexMax (inclusive) set values 0..n-1, up to maxRadios groups per page
+  static constexpr int maxRadios = ofxControllerState::maxRadios;
   void radio(int indexMin, int indexMax, ofParameter <int> & param, int color = ofxLCLeds::Red, int offColor = ofxLCLeds::Off);
   
-  void knob(int index, ofParameter <float> & param, float min, float max);
-  void knob(int index, ofParameter <int> & param, int min, int max);
-  void knob(int index, ofParameter <float> & param);
-  void knob(int index, ofParameter <int> & param);
+  // The curve shapes the response, it is baked into a lookup table at bind time.
+  void knob(int index, ofParameter <float> & param, float min, float max, const ofxControllerCurve & curve = ofxControllerCurve());
+  void knob(int index, ofParameter <int> & param, int min, int max, const ofxControllerCurve & curve = ofxControllerCurve());
+  void knob(int index, ofParameter <float> & param, const ofxControllerCurve & curve = ofxControllerCurve());
+  void knob(int index, ofParameter <int> & param, const ofxControllerCurve & curve = ofxControllerCurve());
 
   // "Soft takeover" / pickup: ignores incoming knob movements until the
   // physical control reaches the current parameter value (within tolerance).
-  void knobPickup(int index, ofParameter <float> & param, float min, float max, int tolerance = 2);
-  void knobPickup(int index, ofParameter <int> & param, int min, int max, int tolerance = 2);
-  void knobPickup(int index, ofParameter <float> & param, int tolerance = 2);
-  void knobPickup(int index, ofParameter <int> & param, int tolerance = 2);
+  // Armed once when bound (and on page switches), unlike knobTakeover().
+  void knobPickup(int index, ofParameter <float> & param, float min, float max, int tolerance = 2, const ofxControllerCurve & curve = ofxControllerCurve());
+  void knobPickup(int index, ofParameter <int> & param, int min, int max, int tolerance = 2, const ofxControllerCurve & curve = ofxControllerCurve());
+  void knobPickup(int index, ofParameter <float> & param, int tolerance = 2, const ofxControllerCurve & curve = ofxControllerCurve());
+  void knobPickup(int index, ofParameter <int> & param, int tolerance = 2, const ofxControllerCurve & curve = ofxControllerCurve());
+
+  struct PickupStatus {
+    bool armed;      // a takeover binding on this knob waits for the control
+    bool known;      // the control position is known (it moved since binding)
+    float distance;  // parameter minus control position, in MIDI steps
+  };
+
+  // Takeover state of the first armed binding of a knob, main thread only.
+  PickupStatus getPickupStatus(int index) const;
+
+  // Name of the first parameter bound to a knob, empty if none, main thread only.
+  std::string getKnobName(int index) const;
+
+  // Knob binding with an explicit takeover mode, tolerance is in MIDI steps.
+  // Takeover re-arms every time the parameter is changed by something else.
+  void knobTakeover(int index, ofParameter <float> & param, float min, float max, TakeoverMode mode, int tolerance = 2, const ofxControllerCurve & curve = ofxControllerCurve());
+  void knobTakeover(int index, ofParameter <int> & param, int min, int max, TakeoverMode mode, int tolerance = 2, const ofxControllerCurve & curve = ofxControllerCurve());
+  void knobTakeover(int index, ofParameter <float> & param, TakeoverMode mode, int tolerance = 2, const ofxControllerCurve & curve = ofxControllerCurve());
+  void knobTakeover(int index, ofParameter <int> & param, TakeoverMode mode, int tolerance = 2, const ofxControllerCurve & curve = ofxControllerCurve());
+
+  // 14 bit knob: the knob cc is the msb and lsbControl the lsb (-1 for msb + 32,
+  // as in the MIDI spec). The msb applies at once, a following lsb refines it,
+  // so devices that only send msb still work with 7 bit resolution.
+  void knobHiRes(int index, ofParameter <float> & param, float min, float max, int lsbControl = -1, const ofxControllerCurve & curve = ofxControllerCurve());
+  void knobHiRes(int index, ofParameter <int> & param, int min, int max, int lsbControl = -1, const ofxControllerCurve & curve = ofxControllerCurve());
+
+  // NRPN binding (cc 99/98 select the number, cc 6/38 send 14 bit data).
+  // While the active page has NRPN bindings cc 6, 38, 98 and 99 are reserved,
+  // unless a knob of the page is bound to them (e.g. the XL fader on cc 6).
+  // The number is kept per channel, the null number (127 / 127) deselects it.
+  void nrpn(int number, ofParameter <float> & param, float min, float max, const ofxControllerCurve & curve = ofxControllerCurve());
+  void nrpn(int number, ofParameter <int> & param, int min, int max, const ofxControllerCurve & curve = ofxControllerCurve());
+
+  // Endless encoder binding: every message moves the parameter by delta * step,
+  // faster turns are accelerated up to `acceleration` times. The parameter is
+  // never out of sync with the control, so there is no takeover.
+  void encoder(int index, ofParameter <float> & param, float min, float max, float step, EncoderMode mode = LC_ENCODER_OFFSET_64, float acceleration = 4.0f);
+  void encoder(int index, ofParameter <int> & param, int min, int max, float step = 1.0f, EncoderMode mode = LC_ENCODER_OFFSET_64, float acceleration = 4.0f);
+  void encoder(int index, ofParameter <float> & param, EncoderMode mode = LC_ENCODER_OFFSET_64, float acceleration = 4.0f); // 1/127 of the range per step
+  void encoder(int index, ofParameter <int> & param, EncoderMode mode = LC_ENCODER_OFFSET_64, float acceleration = 4.0f);
+
+  // Fine mode scales all encoder steps (e.g. while a button is held), coarse is 1.
+  void encoderFine(bool enabled, float scale = 0.1f);
+
+  // Ignores changes smaller than `steps` MIDI steps from the last accepted value
+  // for the current bindings of a knob, against fader noise. 0 disables it.
+  void knobDeadband(int index, int steps);
 
   // Clears all bindings for a given knob index.
   void clearKnob(int index);
+
+  // Low latency binding: the MIDI callback thread writes the mapped value
+  // straight into `target`, bypassing the message buffer and update().
+  // Only bind thread-safe targets here (e.g. values read by the audio thread),
+  // one immediate target per knob; regular bindings on the same knob still work.
+  void knobImmediate(int index, std::atomic <float> & target, float min, float max, const ofxControllerCurve & curve = ofxControllerCurve());
+  void clearKnobImmediate(int index);
+
+  // Immediate binding to a value tap read and ramped per block by the audio thread.
+  // The tap also receives the arrival time, see ofxControllerValueTap::beginBlock().
+  void knobTap(int index, ofxControllerValueTap & tap, float min, float max, const ofxControllerCurve & curve = ofxControllerCurve());
+
+  // Arrival time (ofxControllerClock::now() nanoseconds) of the last message
+  // for a knob or button, 0 if none arrived yet. Safe to call from any thread.
+  uint64_t getKnobTime(int index) const;
+  uint64_t getButtonTime(int index) const;
+
+  // Typed events, queued on the MIDI thread for consumers on their own threads.
+  // Each subscriber gets its own lock free queue with only the events matching
+  // its filter, poll it with queue->pop(event). Up to maxSubscribers.
+  static constexpr int maxSubscribers = 8;
+  std::shared_ptr <ofxControllerEventQueue> subscribe(const ofxControllerEventFilter & filter = ofxControllerEventFilter(), size_t capacity = 1024);
+  void unsubscribe(const std::shared_ptr <ofxControllerEventQueue> & queue);
+
+  // Consistent copy of all control states, published at the end of each update()
+  // that changed something. Lock free, safe to call from any thread.
+  void getState(ofxControllerState & state) const;
+
+  // Update costs and input latency, read them on the update thread.
+  const ofxControllerStats & getStats() const { return stats; }
+  void resetStats();
+
+  // Also mirror the published state into a shared memory segment (e.g. "/launchcontrol")
+  // for other processes, read it there with ofxControllerStateReader. POSIX only.
+  bool publishSharedState(const std::string & segmentName);
+  void stopSharedState();
   
   void knob3(int index, ofParameter <glm::vec3> & param, glm::vec3 min, glm::vec3 max);
   void knob3(int index, ofParameter <glm::vec3> & param);
@@ -80,13 +278,54 @@ public:
   void easing(float speed = 0.5f);
   void disableEasing();
   
+  // Pages are independent sets of bindings for the same controls, built up
+  // front and switched in constant time. Page 0 ("default") always exists.
+  // Binding functions add to the page selected by addPage() / editPage().
+  // Switching re-arms takeover bindings and refreshes the leds.
+  // Binding functions are safe from any thread: they edit a staged copy of the
+  // page that update() publishes in one swap, the first update that doesn't
+  // find a binding call in progress. Controls keep their state, only knobs
+  // with changed bindings re-arm. Page functions (addPage, editPage, setPage,
+  // pageButton, modifier*) are main thread only.
+  int addPage(const std::string & pageName); // creates the page if needed, selects it for editing, returns its index
+  void editPage(int page);
+  void editPage(const std::string & pageName);
+  void setPage(int page);
+  void setPage(const std::string & pageName);
+  int getPage() const;
+  int getNumPages() const;
+  std::string getPageName(int page) const;
+
+  // Pressing the button switches to the page, on every page.
+  void pageButton(int index, int page);
+
+  // Modifier layers: while the modifier is held its page is dispatched instead
+  // of the one selected with setPage(), releasing it switches back. A layer is
+  // a regular page, so every control gets a second mapping.
+  void modifierButton(int index, int page);
+  void modifierCC(int control, int page, int channel = 0); // channel 0 matches any channel
+  bool isModifierHeld() const;
+
   void close();
   
-  void refreshLeds(); // update leds from parameter values
+  void refreshLeds(); // update all leds from parameter values
   
 protected:
-  vector <Binding> buttons;
-  vector <Binding> ccButtons;
+  // called at the end of every update(), after bindings and leds were refreshed
+  virtual void onUpdate(){}
+
+  // called after setPage() switched the active page
+  virtual void onPageChanged(int){}
+
+  // Reconnect hooks, see enableReconnect(). onDisconnect() and onReconnect()
+  // run on the reconnect thread with the ports locked, after midiIn and leds
+  // were closed / reopened: handle other ports there, false retries later.
+  // onReconnected() runs in the next update(), after knobs and leds resynced.
+  virtual void onDisconnect(){}
+  virtual bool onReconnect(){ return true; }
+  virtual void onReconnected(){}
+
+  vector <int>     buttonsNote;
   vector <int>     knobsCC;
   string name;
   
@@ -95,42 +334,197 @@ protected:
   
 private:
   void update(ofEventArgs & events); // update writes changes, use atomics for thread safe control
+  // update() in three steps, called separately by an ofxControllerManager
+  void drain(uint64_t now);  // buffered messages to bindings, gesture timers
+  void flush();              // parameters, leds, callbacks, state
+  void sendLeds();           // the queued led messages
+
+  bool setupPorts(int port, const std::string & portName, int channel); // port -1 opens by name
+  bool isBindable() const { return !inPortName.empty(); } // setup() knows the device
+  void watchPorts();      // reconnect thread
+  void resyncReconnected(); // update thread
 
   void newMidiMessage(ofxMidiMessage & msg);
+  bool isOwnChannel(int msgChannel) const { return channel < 1 || channel > 16 || msgChannel == channel; }
+
+  void processMessage(const ofxMidiMessage & msg, uint64_t time);
+  bool moveEncoder(Binding & binding, int midi, uint64_t time); // true if the value changed
 
-  void processMessage(const ofxMidiMessage & msg);
+  void addCallback(int source, ButtonEvent event, const ofxControllerCallback & callback, CallbackContext context);
+  int callbackSource(const ofxMidiMessage & msg, bool & pressed) const; // -1 if not a button
+  void fireCallbacks(int source, ButtonEvent event);
+  void runCallbacks(); // the update context ones queued by fireCallbacks()
+  bool hasCallback(int source, ButtonEvent event) const;
+  void gesturePress(int source, uint64_t time);
+  void gestureRelease(int source, uint64_t time);
+  void gestureTimeout(int source, uint64_t now);
+  bool processNrpn(const ofxMidiMessage & msg, bool & dirty);    // true if the message was NRPN
+  void setHiRes(int index, int lsbControl);
+
+  void publishState();
+
+  void writeBindings(BindingSet & page);
+
+  std::unique_ptr <BindingSet> makePage(const std::string & pageName) const;
+  int findPage(const std::string & pageName) const;
+  void switchPage(int page);
+  bool processModifier(const ofxMidiMessage & msg); // true if the message was a modifier
+
+  Binding & addKnobBinding(int index);
+  void setupTakeover(Binding & binding, TakeoverMode mode, int tolerance);
+  void armOnce(int index); // the last binding of the edited knob, for knobPickup()
+  BindingSet & editedSet(); // staged copy of the edited page, bindingMutex must be held
+  void publishBindings();
+  void carryBindings(BindingSet & next, const BindingSet & live, bool isActive); // runtime state of unchanged bindings
+
+  // Parameter listeners mark the leds of their buttons, update() resends
+  // only those. Safe from any thread.
+  void markLed(int index);
+  void refreshLed(int index); // from the active page
+  void flushLeds();
+  void resyncKnobs(BindingSet & page); // after a switch or a reconnect
+  void resyncKnob(BindingSet & page, size_t index);
+  float pickupPosition(const Binding & binding) const;
+  bool checkTakeover(Binding & binding, int midi); // true when the control picked up
+
+  void bindImmediate(int index, std::atomic <float> * target, std::atomic <uint64_t> * time, float min, float max, const ofxControllerCurve & curve);
 
   void removeParameterListeners();
   void clearBindings();
   
   std::atomic <bool> buttonLedsEnabled;
+  std::atomic <uint16_t> channelMask;
+  std::atomic <int> inputTypes;
   
   std::vector <ofxMidiMessage> buffer;
+  std::vector <uint64_t> bufferTimes; // arrival time of each buffered message
   std::atomic <int> written;
   int lastRead;
   
   std::atomic <bool> bUpdate;
+
+  ofxControllerState state;   // written by update() only
+  bool bStateChanged;
+  ofxControllerSeqlock <ofxControllerState> publishedState;
+  std::unique_ptr <ofxControllerStatePublisher> sharedState;
   
-  std::vector <vector <Binding> > knobs;
-  std::vector <RadioGroup>    radios;
+  // published pages, replaced by publishBindings(), only active points into them
+  std::vector <std::unique_ptr <BindingSet> > pages;
+  BindingSet * active;  // dispatched by processMessage() and update()
+  int activePage;
+
+  // Copy on write: binding functions edit the staged sets under the mutex,
+  // update() only tries it, copies the changed sets and swaps them into pages.
+  // The mutex is the reclamation guard: pages and active are only read on the
+  // update thread, which also swaps them, and the MIDI thread never touches a
+  // binding set (it only reads the immediate slots and index tables below).
+  // So no pointer into a replaced set outlives the swap, it is freed at once.
+  std::recursive_mutex bindingMutex;
+  std::vector <std::unique_ptr <BindingSet> > staged;   // parallel to pages
+  std::vector <uint8_t> stagedChanged;
+  std::atomic <bool> bStagedChanged;
+
+  int editedPage;
+  std::vector <int> pageForButton; // -1 if the button is not a page button
+  int basePage;                    // selected with setPage(), active when no modifier is held
+
+  struct Modifier {
+    int status;   // MIDI_NOTE_ON for buttons or MIDI_CONTROL_CHANGE
+    int number;   // note or cc
+    int channel;  // 0 for any
+    int page;
+  };
+  std::vector <Modifier> modifiers;
+  int heldModifier;                // -1 if none
+  std::atomic <bool> bWritingKnobs;
+
+  std::unique_ptr <std::atomic <bool> []> ledDirty; // one per button, sized in setup()
+  size_t numLeds;
+  std::atomic <bool> bLedsDirty;   // any ledDirty set
+  std::atomic <bool> bRefreshLeds; // all of them, after a page switch or publish
+
+  // led messages of one update, the last color per note wins
+  std::vector <std::pair <int, int> > ledQueue;
+  int16_t ledQueued[128];          // index in ledQueue, -1 if none
+  bool bQueueLeds;
+
+  ofxControllerManager * manager;  // nullptr unless owned by one
+
+  // Reconnect. The names are set by setup(), also when the device is missing,
+  // the thread only reads them.
+  std::string inPortName;
+  std::string outPortName;
+  std::recursive_mutex portMutex;   // midiIn and leds while they are reopened
+  std::thread reconnectThread;
+  std::mutex reconnectMutex;
+  std::condition_variable reconnectCondition;
+  bool bReconnectRunning;
+  uint64_t reconnectInterval;       // ms
+  std::atomic <bool> bConnected;
+  std::atomic <bool> bReconnected;  // the update thread has to resync
+  ofxControllerStats stats;
+
+  // sized in setup(), never resized while the MIDI callback is attached
+  std::vector <ImmediateSlot> immediates;
+  std::vector <int>           knobIndexForCC; // 128 entries, -1 if no knob
+  std::vector <int>           buttonIndexForNote; // 128 entries, -1 if no button
+  std::vector <std::atomic <uint64_t> > knobTimes;
+  std::vector <std::atomic <uint64_t> > buttonTimes;
   
   int buttonsColor;
   int channel;
   
-  void radioChanged(int & value);
-  void buttonChangedB(bool & value);
-  void buttonChangedF(float & value);
-  void buttonChangedI(int & value);
   void knob3Changed(glm::vec3 & value);
   
   void clearLeds(); // all leds off
+  void sendLed(int note, int color); // queued while updating, sent at the end
   
   bool bEasing;
   float easeAmount;
+
+  float encoderScale; // fine mode step multiplier, 1 when coarse
+
+  // Callback sources are the button indices followed by the 128 cc numbers.
+  std::unique_ptr <MidiCallbackSlot[]> midiCallbacks; // press and release per source
+  size_t numMidiCallbacks;
+  std::atomic <bool> midiCallbacksBound;
+  std::vector <uint8_t> midiHeld;           // MIDI thread only
+
+  // Gesture recognizer, one state and one timer per source.
+  enum GesturePhase : uint8_t {
+    LC_GESTURE_IDLE = 0,
+    LC_GESTURE_DOWN,         // pressed, waiting for release or long press
+    LC_GESTURE_HELD,         // long press fired, repeating
+    LC_GESTURE_WAIT_SECOND,  // tapped, waiting for a double tap
+    LC_GESTURE_SECOND_DOWN   // double tap fired, waiting for release
+  };
+  std::vector <GesturePhase> gestures;
+  ofxControllerTimerWheel gestureTimers;
+  uint64_t longPressTime;
+  uint64_t doubleTapTime;
+  uint64_t repeatTime;
+  std::vector <std::pair <BindingSet *, size_t> > pendingCallbacks; // reserved, never grows
+
+  // Event subscribers, the MIDI thread reads the queue pointers.
+  std::unique_ptr <EventSubscriber[]> subscribers;
+  std::atomic <int> numSubscribers;
+  void publishEvent(const ofxMidiMessage & msg, uint64_t time);
+
+  int nrpnNumber[16]; // per channel, selected by cc 99/98, -1 if none
+  int nrpnMsb[16];    // last data msb (cc 6)
   
+  struct TakeoverFlags {
+    std::atomic <bool> armed { false };
+    std::atomic <bool> dirty { false }; // parameter changed, pickupMidi is stale
+    std::atomic <bool> rearm { true };  // outside changes arm it again
+  };
+
   struct Binding {
     Binding();
     Binding(const Binding & other);
+
+    bool sameAs(const Binding & other) const; // same control and target, maybe edited
+    void carryState(const Binding & live);    // runtime values of the published copy
     
     int controlNum;
     TypeCode typeCode;            // 0 for unassigned, 1 for bool, 2 for float, 3 for int, 4 for radio
@@ -141,15 +535,30 @@ private:
     ofParameter <float> * pParamf;
     ofParameter <int> * pParami;
     ofParameter <bool> * pParamb;
-    std::function<void()> buttonListener;
     
     std::atomic <float> value;
     std::atomic <float> values[3];
 
-    // Soft takeover / pickup.
-    bool pickupEnabled;
-    bool pickupArmed;
+    // Soft takeover / pickup, the flags are shared by all copies of the
+    // binding and set by the parameter listener from any thread.
+    TakeoverMode takeover;
+    std::shared_ptr <TakeoverFlags> pickup;
     int pickupTolerance;
+    float pickupMidi;               // parameter value in MIDI space
+    int lastMidi;                   // last received value, -1 if none
+
+    int deadband;                   // in MIDI steps, 0 = off
+    int acceptedMidi;               // last value that passed the deadband
+
+    // Relative encoder, the value accumulates the deltas until update() writes it.
+    bool relative;
+    EncoderMode encoderMode;
+    float encoderStep;
+    float encoderAcceleration;
+    uint64_t lastEventTime;
+
+    int lsbControl;                 // 14 bit pair lsb cc, -1 for 7 bit
+    int msb;                        // last received msb of the pair
 
     std::atomic <bool> bActive;
     float minf;
@@ -158,6 +567,8 @@ private:
     int maxi;
     glm::vec3 minv3;
     glm::vec3 maxv3;
+
+    float lut[ofxControllerCurve::tableSize]; // MIDI value -> target value
     
     int radioGroup;
     int radioValue;
@@ -177,6 +588,57 @@ private:
     std::atomic <bool>        bUpdate;
     int color;
     int offColor;
+    std::shared_ptr <std::atomic <int> > lit; // value shown by the leds, shared with the listener
+  };
+
+  struct ImmediateSlot {
+    ImmediateSlot();
+    ImmediateSlot(const ImmediateSlot & other);
+
+    // odd while a writer is replacing target, time and lut; the MIDI thread
+    // drops the value when it changed during its read, so it never pairs an
+    // old target with a new table
+    std::atomic <uint32_t> generation;
+    std::atomic <std::atomic <float> *> target; // nullptr when unbound
+    std::atomic <std::atomic <uint64_t> *> time; // optional arrival time output
+    std::atomic <float> lut[ofxControllerCurve::tableSize];
+  };
+
+  struct Callback {
+    int source;
+    ButtonEvent event;
+    CallbackContext context;
+    ofxControllerCallback callback;
+  };
+
+  struct MidiCallbackSlot {
+    MidiCallbackSlot();
+
+    ofxControllerCallback callback;
+    std::atomic <bool> armed;  // callback can be called
+    std::atomic <int> busy;    // calls in progress on the MIDI thread
+  };
+
+  struct EventSubscriber {
+    EventSubscriber();
+
+    std::atomic <ofxControllerEventQueue *> queue; // nullptr when free
+    std::atomic <int> busy;                        // pushes in progress on the MIDI thread
+    std::shared_ptr <ofxControllerEventQueue> owner;
+  };
+
+  struct BindingSet {
+    std::string name;
+    vector <Binding> buttons;
+    vector <std::shared_ptr <ofEventListener> > buttonListeners; // parallel to buttons
+    vector <Binding> ccButtons;
+    vector <vector <Binding> > knobs;
+    vector <vector <std::shared_ptr <ofEventListener> > > knobListeners; // parallel to knobs, shared by the copies
+    vector <Binding> nrpns;
+    RadioGroup radios[maxRadios];
+    std::shared_ptr <ofEventListener> radioListeners[maxRadios];
+    int numRadios = 0;
+    vector <Callback> callbacks;
   };
   
 };
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Small-buffer void() callable.
+ *
+ * Stores lambdas (and other callables) inline up to `capacity` bytes, so
+ * binding and calling never allocate. Bigger callables don't compile, capture
+ * a pointer to your state instead. A std::function fits too, for existing
+ * code, but then its own captures may allocate when it is created.
+ */
+class ofxControllerCallback {
+public:
+  static constexpr size_t capacity = 48;
+
+  ofxControllerCallback() : invokeFn(nullptr), manageFn(nullptr) {}
+
+  ofxControllerCallback(std::nullptr_t) : ofxControllerCallback() {}
+
+  template <typename F,
+            typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, ofxControllerCallback>::value>::type>
+  ofxControllerCallback(F&& f) : ofxControllerCallback() {
+    using Callable = typename std::decay<F>::type;
+    static_assert(sizeof(Callable) <= capacity, "callback captures too much, capture a pointer instead");
+    static_assert(alignof(Callable) <= alignof(std::max_align_t), "callback alignment not supported");
+    new (storage) Callable(std::forward<F>(f));
+    invokeFn = [](void* p) { (*static_cast<Callable*>(p))(); };
+    manageFn = [](void* dst, void* src) {
+      if (dst) {
+        new (dst) Callable(*static_cast<Callable*>(src));
+      } else {
+        static_cast<Callable*>(src)->~Callable();
+      }
+    };
+  }
+
+  ofxControllerCallback(const ofxControllerCallback& other) : ofxControllerCallback() {
+    copyFrom(other);
+  }
+
+  ofxControllerCallback& operator=(const ofxControllerCallback& other) {
+    if (this != &other) {
+      reset();
+      copyFrom(other);
+    }
+    return *this;
+  }
+
+  ~ofxControllerCallback() { reset(); }
+
+  void reset() {
+    if (manageFn) {
+      manageFn(nullptr, storage);
+    }
+    invokeFn = nullptr;
+    manageFn = nullptr;
+  }
+
+  explicit operator bool() const { return invokeFn != nullptr; }
+
+  void operator()() {
+    if (invokeFn) {
+      invokeFn(storage);
+    }
+  }
+
+private:
+  void copyFrom(const ofxControllerCallback& other) {
+    if (other.manageFn) {
+      other.manageFn(storage, const_cast<unsigned char*>(other.storage));
+      invokeFn = other.invokeFn;
+      manageFn = other.manageFn;
+    }
+  }
+
+  alignas(std::max_align_t) unsigned char storage[capacity];
+  void (*invokeFn)(void*);
+  void (*manageFn)(void* dst, void* src);  // copies into dst, destroys src when dst is null
+};
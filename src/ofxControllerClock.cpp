@@ -0,0 +1,19 @@
+#include "ofxControllerClock.h"
+
+#include <chrono>
+
+uint64_t ofxControllerClock::now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int ofxControllerClock::sampleOffset(uint64_t eventTime, uint64_t blockStartTime, double sampleRate, int numFrames) {
+  if (numFrames <= 0 || eventTime <= blockStartTime) {
+    return 0;
+  }
+  double offset = double(eventTime - blockStartTime) * sampleRate * 1.0e-9;
+  if (offset >= numFrames - 1) {
+    return numFrames - 1;
+  }
+  return static_cast<int>(offset);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * High resolution clock used to stamp incoming controller events.
+ *
+ * Times are nanoseconds of std::chrono::steady_clock, so they can be compared
+ * with times taken on any thread (e.g. at the start of an audio callback).
+ */
+class ofxControllerClock {
+public:
+  /**
+   * Current time in nanoseconds.
+   */
+  static uint64_t now();
+
+  /**
+   * Sample offset of an event inside an audio block.
+   * @param eventTime Event arrival time, from now() or a controller getter
+   * @param blockStartTime Time that sample 0 of the block stands for. For a
+   *        constant one-block latency pass the start time of the previous
+   *        callback, so that events of the last block period spread over this one.
+   * @param sampleRate Audio sample rate in Hz
+   * @param numFrames Block size
+   * @return Offset in [0, numFrames - 1]; 0 for events older than the block.
+   */
+  static int sampleOffset(uint64_t eventTime, uint64_t blockStartTime, double sampleRate, int numFrames);
+};
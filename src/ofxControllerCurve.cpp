@@ -0,0 +1,76 @@
+#include "ofxControllerCurve.h"
+
+#include <cmath>
+
+ofxControllerCurve::ofxControllerCurve()
+    : shape(Linear), amount(0.0f) {
+}
+
+ofxControllerCurve ofxControllerCurve::linear() {
+  return ofxControllerCurve();
+}
+
+ofxControllerCurve ofxControllerCurve::logarithmic(float amount) {
+  ofxControllerCurve curve;
+  curve.shape = Logarithmic;
+  curve.amount = amount > 0.0f ? amount : 4.0f;
+  return curve;
+}
+
+ofxControllerCurve ofxControllerCurve::exponential(float amount) {
+  ofxControllerCurve curve;
+  curve.shape = Exponential;
+  curve.amount = amount > 0.0f ? amount : 4.0f;
+  return curve;
+}
+
+ofxControllerCurve ofxControllerCurve::sCurve(float amount) {
+  ofxControllerCurve curve;
+  curve.shape = SCurve;
+  curve.amount = amount > 0.0f ? amount : 2.0f;
+  return curve;
+}
+
+ofxControllerCurve ofxControllerCurve::custom(std::function<float(float)> shape) {
+  ofxControllerCurve curve;
+  if (shape) {
+    curve.shape = Custom;
+    curve.function = shape;
+  }
+  return curve;
+}
+
+float ofxControllerCurve::operator()(float x) const {
+  switch (shape) {
+    case Logarithmic:
+      return std::log1p(std::expm1(amount) * x) / amount;
+
+    case Exponential:
+      return std::expm1(amount * x) / std::expm1(amount);
+
+    case SCurve: {
+      float a = std::pow(x, amount);
+      float b = std::pow(1.0f - x, amount);
+      return (a + b) > 0.0f ? a / (a + b) : x;
+    }
+
+    case Custom:
+      return function(x);
+
+    case Linear:
+    default:
+      return x;
+  }
+}
+
+void ofxControllerCurve::fill(float* table, float min, float max) const {
+  for (int i = 0; i < tableSize; ++i) {
+    float x = float(i) / float(tableSize - 1);
+    table[i] = min + (*this)(x) * (max - min);
+  }
+  // exact endpoints, whatever the shape rounding
+  if (shape != Custom) {
+    table[0] = min;
+    table[tableSize - 1] = max;
+  }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <functional>
+
+/**
+ * Response curve from a normalized control position (0-1) to a normalized
+ * output (0-1). Bindings bake the curve into a 128 entry lookup table when
+ * they are created, so the shape costs nothing at dispatch time.
+ */
+class ofxControllerCurve {
+public:
+  enum Shape {
+    Linear = 0,
+    Logarithmic = 1,  // fast start, fine control at the top
+    Exponential = 2,  // fine control at the bottom, e.g. gain or frequency
+    SCurve = 3,       // fine control at both ends
+    Custom = 4
+  };
+
+  static constexpr int tableSize = 128;
+
+  ofxControllerCurve();  // linear
+
+  static ofxControllerCurve linear();
+  static ofxControllerCurve logarithmic(float amount = 4.0f);
+  static ofxControllerCurve exponential(float amount = 4.0f);
+  static ofxControllerCurve sCurve(float amount = 2.0f);
+  static ofxControllerCurve custom(std::function<float(float)> shape);
+
+  Shape getShape() const { return shape; }
+
+  /**
+   * Normalized output for a normalized input.
+   */
+  float operator()(float x) const;
+
+  /**
+   * Fill table[0..tableSize) with the values for MIDI 0-127 mapped to min..max.
+   */
+  void fill(float* table, float min, float max) const;
+
+private:
+  Shape shape;
+  float amount;
+  std::function<float(float)> function;
+};
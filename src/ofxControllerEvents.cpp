@@ -0,0 +1,86 @@
+#include "ofxControllerEvents.h"
+
+namespace {
+uint64_t rangeMask(int first, int last) {
+  uint64_t mask = 0;
+  for (int i = first < 0 ? 0 : first; i <= last && i < 64; ++i) {
+    mask |= uint64_t(1) << i;
+  }
+  return mask;
+}
+}  // namespace
+
+ofxControllerEventFilter::ofxControllerEventFilter()
+    : kinds(~0u), knobs(~uint64_t(0)), buttons(~uint64_t(0)), controls{~uint64_t(0), ~uint64_t(0)} {}
+
+ofxControllerEventFilter& ofxControllerEventFilter::onlyKinds(std::initializer_list<ofxControllerEvent::Kind> only) {
+  kinds = 0;
+  for (auto kind : only) {
+    kinds |= 1u << kind;
+  }
+  return *this;
+}
+
+ofxControllerEventFilter& ofxControllerEventFilter::onlyKnobs(int first, int last) {
+  knobs = rangeMask(first, last);
+  return *this;
+}
+
+ofxControllerEventFilter& ofxControllerEventFilter::onlyRow(int row, int perRow) {
+  return onlyKnobs(row * perRow, row * perRow + perRow - 1);
+}
+
+ofxControllerEventFilter& ofxControllerEventFilter::onlyButtons(int first, int last) {
+  buttons = rangeMask(first, last);
+  return *this;
+}
+
+bool ofxControllerEventFilter::matches(const ofxControllerEvent& event) const {
+  if (!(kinds & (1u << event.kind)) || event.index < 0) {
+    return false;
+  }
+  switch (event.kind) {
+    case ofxControllerEvent::Knob:
+      return event.index < 64 && (knobs >> event.index) & 1;
+    case ofxControllerEvent::Button:
+      return event.index < 64 && (buttons >> event.index) & 1;
+    case ofxControllerEvent::ControlButton:
+      return event.index < 128 && (controls[event.index >> 6] >> (event.index & 63)) & 1;
+  }
+  return false;
+}
+
+ofxControllerEventQueue::ofxControllerEventQueue(const ofxControllerEventFilter& filter, size_t capacity)
+    : filter(filter), head(0), tail(0), dropped(0) {
+  size_t size = 2;
+  while (size < capacity) {
+    size <<= 1;
+  }
+  events.resize(size);
+  mask = size - 1;
+}
+
+bool ofxControllerEventQueue::push(const ofxControllerEvent& event) {
+  size_t t = tail.load(std::memory_order_relaxed);
+  if (t - head.load(std::memory_order_acquire) >= events.size()) {
+    dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  events[t & mask] = event;
+  tail.store(t + 1, std::memory_order_release);
+  return true;
+}
+
+bool ofxControllerEventQueue::pop(ofxControllerEvent& event) {
+  size_t h = head.load(std::memory_order_relaxed);
+  if (h == tail.load(std::memory_order_acquire)) {
+    return false;
+  }
+  event = events[h & mask];
+  head.store(h + 1, std::memory_order_release);
+  return true;
+}
+
+size_t ofxControllerEventQueue::size() const {
+  return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+/**
+ * One control change, as delivered to ofxControllerBase::subscribe() queues.
+ */
+struct ofxControllerEvent {
+  enum Kind : uint8_t {
+    Knob = 0,          // knob or fader, index is the knob index
+    Button = 1,        // note button, index is the button index
+    ControlButton = 2  // any other cc, index is the cc number
+  };
+
+  Kind kind;
+  uint8_t raw;   // MIDI value 0-127 (velocity for buttons)
+  int16_t index;
+  float scaled;  // raw / 127 for knobs, 1 pressed / 0 released for buttons
+  uint64_t time; // arrival time, ofxControllerClock::now()
+};
+
+/**
+ * Which events a subscriber receives, everything by default.
+ * Controls are bit masks, so matching costs the same for any filter.
+ */
+struct ofxControllerEventFilter {
+  ofxControllerEventFilter();
+
+  /**
+   * Only these kinds, e.g. onlyKinds({ofxControllerEvent::Knob}).
+   */
+  ofxControllerEventFilter& onlyKinds(std::initializer_list<ofxControllerEvent::Kind> kinds);
+
+  /**
+   * Only knobs first..last (inclusive), or a row of `perRow` knobs.
+   */
+  ofxControllerEventFilter& onlyKnobs(int first, int last);
+  ofxControllerEventFilter& onlyRow(int row, int perRow = 8);
+
+  /**
+   * Only buttons first..last (inclusive).
+   */
+  ofxControllerEventFilter& onlyButtons(int first, int last);
+
+  bool matches(const ofxControllerEvent& event) const;
+
+  uint32_t kinds;        // bit per Kind
+  uint64_t knobs;        // bit per knob index
+  uint64_t buttons;      // bit per button index
+  uint64_t controls[2];  // bit per cc number
+};
+
+/**
+ * Single producer, single consumer lock free event queue.
+ *
+ * The controller pushes from the MIDI thread, one consumer thread pops.
+ * A full queue drops the new event and counts it.
+ */
+class ofxControllerEventQueue {
+public:
+  ofxControllerEventQueue(const ofxControllerEventFilter& filter, size_t capacity);
+
+  bool push(const ofxControllerEvent& event);  // producer only
+  bool pop(ofxControllerEvent& event);         // consumer only
+
+  size_t size() const;
+  uint64_t getDropped() const { return dropped.load(std::memory_order_relaxed); }
+  const ofxControllerEventFilter& getFilter() const { return filter; }
+
+private:
+  const ofxControllerEventFilter filter;
+  std::vector<ofxControllerEvent> events;
+  size_t mask;
+  std::atomic<size_t> head;  // next to pop
+  std::atomic<size_t> tail;  // next to push
+  std::atomic<uint64_t> dropped;
+};
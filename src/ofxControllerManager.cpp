@@ -0,0 +1,101 @@
+#include "ofxControllerManager.h"
+
+ofxControllerManager::ofxControllerManager() : registered(false) {}
+
+ofxControllerManager::~ofxControllerManager() {
+  close();
+}
+
+void ofxControllerManager::registerUpdate() {
+  if (!registered) {
+    int prio = 0;  // OF_EVENT_PRIORITY_BEFORE_APP, as the controllers do
+    ofAddListener(ofEvents().update, this, &ofxControllerManager::appUpdate, prio);
+    registered = true;
+  }
+}
+
+void ofxControllerManager::appUpdate(ofEventArgs&) {
+  update();
+}
+
+void ofxControllerManager::update() {
+  uint64_t start = ofxControllerClock::now();
+
+  // all the input first, so every controller sees the same point in time
+  for (auto& controller : controllers) {
+    if (controller->active) {  // set up
+      controller->drain(start);
+    }
+  }
+  for (auto& controller : controllers) {
+    if (controller->active) {
+      controller->flush();
+    }
+  }
+
+  // then the output, one port after the other. The port names only change
+  // in setup(), the ports themselves may be reopened by a reconnect thread
+  // and are only touched by sendLeds() under the controller's port lock.
+  bool changed = sortedPorts.size() != controllers.size();
+  for (size_t i = 0; i < controllers.size() && !changed; ++i) {
+    changed = controllers[i]->outPortName != sortedPorts[i];
+  }
+  if (changed) {
+    sortPorts();
+  }
+  for (size_t i : sendOrder) {
+    controllers[i]->sendLeds();
+  }
+
+  stats.addUpdate(ofxControllerClock::now() - start);
+}
+
+void ofxControllerManager::sortPorts() {
+  // stable: controllers on the same port keep the order they were added in
+  sendOrder.clear();
+  sortedPorts.clear();
+  for (auto& controller : controllers) {
+    sortedPorts.push_back(controller->outPortName);
+  }
+  std::vector<bool> placed(controllers.size(), false);
+  for (size_t i = 0; i < controllers.size(); ++i) {
+    if (placed[i]) {
+      continue;
+    }
+    for (size_t j = i; j < controllers.size(); ++j) {
+      if (!placed[j] && sortedPorts[j] == sortedPorts[i]) {
+        sendOrder.push_back(j);
+        placed[j] = true;
+      }
+    }
+  }
+}
+
+ofxControllerStats ofxControllerManager::getStats() const {
+  ofxControllerStats combined = stats;
+  for (auto& controller : controllers) {
+    combined.merge(controller->getStats());
+  }
+  return combined;
+}
+
+void ofxControllerManager::resetStats() {
+  stats = ofxControllerStats();
+  for (auto& controller : controllers) {
+    controller->resetStats();
+  }
+}
+
+void ofxControllerManager::close() {
+  if (registered) {
+    int prio = 0;
+    ofRemoveListener(ofEvents().update, this, &ofxControllerManager::appUpdate, prio);
+    registered = false;
+  }
+  for (auto& controller : controllers) {
+    controller->close();
+  }
+  controllers.clear();
+  sendOrder.clear();
+  sortedPorts.clear();
+}
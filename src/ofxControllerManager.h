@@ -0,0 +1,74 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ofxControllerBase.h"
+#include "ofxControllerStats.h"
+
+/**
+ * Owns several controllers and updates them together.
+ *
+ * Managed controllers don't register their own update listener. On every
+ * app update the manager drains the message buffers of all controllers,
+ * then writes their bindings and runs their callbacks, then sends their led
+ * changes, always in the order the controllers were added. Controllers
+ * sharing an output port send one after the other, but each led change is
+ * still its own message: ofxMidi has no multi message send.
+ *
+ *     ofxControllerManager controllers;
+ *     auto& lc = controllers.add<ofxLaunchControl>();
+ *     auto& xl = controllers.add<ofxLaunchControlXL>();
+ *     lc.setup(1);
+ *     xl.setup(2);
+ */
+class ofxControllerManager {
+public:
+  ofxControllerManager();
+  ~ofxControllerManager();
+
+  ofxControllerManager(const ofxControllerManager&) = delete;
+  ofxControllerManager& operator=(const ofxControllerManager&) = delete;
+
+  /**
+   * Creates a controller owned by the manager, call its setup() next.
+   */
+  template <typename T>
+  T& add() {
+    std::unique_ptr<T> controller(new T());
+    T& ref = *controller;
+    ref.manager = this;
+    controllers.push_back(std::move(controller));
+    registerUpdate();
+    return ref;
+  }
+
+  size_t size() const { return controllers.size(); }
+  ofxControllerBase& operator[](size_t i) { return *controllers[i]; }
+
+  /**
+   * One pass over all controllers, called by the app update event.
+   */
+  void update();
+
+  /**
+   * Combined counts of all controllers, update times of the whole pass.
+   */
+  ofxControllerStats getStats() const;
+  const ofxControllerStats& getStats(size_t i) const { return controllers[i]->getStats(); }
+  void resetStats();
+
+  void close();  // closes and removes all controllers
+
+private:
+  void appUpdate(ofEventArgs&);
+  void registerUpdate();
+  void sortPorts();
+
+  std::vector<std::unique_ptr<ofxControllerBase> > controllers;
+  std::vector<size_t> sendOrder;        // controller indices grouped by output port
+  std::vector<std::string> sortedPorts;  // output port names sendOrder was built from
+  ofxControllerStats stats;
+  bool registered;
+};
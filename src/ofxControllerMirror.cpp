@@ -0,0 +1,115 @@
+#include "ofxControllerMirror.h"
+
+#include <algorithm>
+
+#include "ofxLaunchControlXL.h"
+
+ofxControllerMirror::ofxControllerMirror()
+    : takeover(ofxControllerBase::LC_TAKEOVER_CROSSING), tolerance(2) {}
+
+void ofxControllerMirror::add(ofxControllerBase& unit) {
+  if (std::find(units.begin(), units.end(), &unit) == units.end()) {
+    units.push_back(&unit);
+  }
+}
+
+void ofxControllerMirror::clear() {
+  units.clear();
+}
+
+void ofxControllerMirror::setTakeover(ofxControllerBase::TakeoverMode mode, int steps) {
+  takeover = mode;
+  tolerance = steps;
+}
+
+// Each unit ignores its own writes, so only the units that were not moved
+// re-arm when a parameter changes.
+void ofxControllerMirror::knob(int index, ofParameter<float>& param, float min, float max, const ofxControllerCurve& curve) {
+  for (auto* unit : units) {
+    unit->knobTakeover(index, param, min, max, takeover, tolerance, curve);
+  }
+}
+
+void ofxControllerMirror::knob(int index, ofParameter<int>& param, int min, int max, const ofxControllerCurve& curve) {
+  for (auto* unit : units) {
+    unit->knobTakeover(index, param, min, max, takeover, tolerance, curve);
+  }
+}
+
+void ofxControllerMirror::knob(int index, ofParameter<float>& param, const ofxControllerCurve& curve) {
+  for (auto* unit : units) {
+    unit->knobTakeover(index, param, takeover, tolerance, curve);
+  }
+}
+
+void ofxControllerMirror::knob(int index, ofParameter<int>& param, const ofxControllerCurve& curve) {
+  for (auto* unit : units) {
+    unit->knobTakeover(index, param, takeover, tolerance, curve);
+  }
+}
+
+void ofxControllerMirror::knobDeadband(int index, int steps) {
+  for (auto* unit : units) {
+    unit->knobDeadband(index, steps);
+  }
+}
+
+void ofxControllerMirror::clearKnob(int index) {
+  for (auto* unit : units) {
+    unit->clearKnob(index);
+  }
+}
+
+void ofxControllerMirror::clearCallbacks() {
+  for (auto* unit : units) {
+    unit->clearCallbacks();
+  }
+}
+
+int ofxControllerMirror::addPage(const std::string& pageName) {
+  int page = -1;
+  for (auto* unit : units) {
+    page = unit->addPage(pageName);
+  }
+  return page;
+}
+
+void ofxControllerMirror::editPage(int page) {
+  for (auto* unit : units) {
+    unit->editPage(page);
+  }
+}
+
+void ofxControllerMirror::editPage(const std::string& pageName) {
+  for (auto* unit : units) {
+    unit->editPage(pageName);
+  }
+}
+
+void ofxControllerMirror::setPage(int page) {
+  for (auto* unit : units) {
+    unit->setPage(page);
+  }
+}
+
+void ofxControllerMirror::setPage(const std::string& pageName) {
+  for (auto* unit : units) {
+    unit->setPage(pageName);
+  }
+}
+
+void ofxControllerMirror::enablePickupFeedback(bool showOnDisplay, float rateHz, int maxLedsPerUpdate) {
+  for (auto* unit : units) {
+    if (auto* xl = dynamic_cast<ofxLaunchControlXL*>(unit)) {
+      xl->enablePickupFeedback(showOnDisplay, rateHz, maxLedsPerUpdate);
+    }
+  }
+}
+
+void ofxControllerMirror::disablePickupFeedback() {
+  for (auto* unit : units) {
+    if (auto* xl = dynamic_cast<ofxLaunchControlXL*>(unit)) {
+      xl->disablePickupFeedback();
+    }
+  }
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ofxControllerBase.h"
+
+/**
+ * Identical controllers bound to the same parameters, e.g. a spare unit.
+ *
+ * Every binding is made on all the units with the same index, so input from
+ * any of them applies and the last one moved wins. Knobs are bound with
+ * takeover: when one unit changes a parameter the knobs of the others are
+ * armed and pick it up instead of jumping. Button and radio leds follow the
+ * parameters on every unit through their regular led updates, page switches
+ * (and the XL page display) happen on all of them.
+ *
+ * The XL display content is not copied from one unit to the other: pickup
+ * feedback, see enablePickupFeedback(), shows on each unit the direction and
+ * distance of its own controls, which are at their own positions.
+ *
+ *     ofxControllerMirror mirror;
+ *     mirror.add(xlMain);
+ *     mirror.add(xlSpare);
+ *     mirror.knob(0, cutoff);
+ *     mirror.toggle(0, bypass);
+ *
+ * knobHiRes(), nrpn(), knobImmediate() and knobTap() have no takeover, the
+ * last message of any unit applies as it is. Units must outlive the mirror.
+ */
+class ofxControllerMirror {
+public:
+  ofxControllerMirror();
+
+  void add(ofxControllerBase& unit);
+  void clear();
+  const std::vector<ofxControllerBase*>& getUnits() const { return units; }
+
+  /**
+   * Takeover of knob() bindings, crossing with 2 steps of tolerance by default.
+   */
+  void setTakeover(ofxControllerBase::TakeoverMode mode, int tolerance = 2);
+
+  // Unlike ofxControllerBase::knob() these bind with takeover, see setTakeover().
+  void knob(int index, ofParameter<float>& param, float min, float max, const ofxControllerCurve& curve = ofxControllerCurve());
+  void knob(int index, ofParameter<int>& param, int min, int max, const ofxControllerCurve& curve = ofxControllerCurve());
+  void knob(int index, ofParameter<float>& param, const ofxControllerCurve& curve = ofxControllerCurve());
+  void knob(int index, ofParameter<int>& param, const ofxControllerCurve& curve = ofxControllerCurve());
+
+  // Same arguments as the ofxControllerBase functions, bound on every unit.
+  template <typename... Args>
+  void knobPickup(Args&&... args) {
+    for (auto* unit : units) unit->knobPickup(args...);
+  }
+  template <typename... Args>
+  void knobTakeover(Args&&... args) {
+    for (auto* unit : units) unit->knobTakeover(args...);
+  }
+  template <typename... Args>
+  void knobHiRes(Args&&... args) {
+    for (auto* unit : units) unit->knobHiRes(args...);
+  }
+  template <typename... Args>
+  void nrpn(Args&&... args) {
+    for (auto* unit : units) unit->nrpn(args...);
+  }
+  template <typename... Args>
+  void encoder(Args&&... args) {
+    for (auto* unit : units) unit->encoder(args...);
+  }
+  template <typename... Args>
+  void button(Args&&... args) {
+    for (auto* unit : units) unit->button(args...);
+  }
+  template <typename... Args>
+  void momentary(Args&&... args) {
+    for (auto* unit : units) unit->momentary(args...);
+  }
+  template <typename... Args>
+  void toggle(Args&&... args) {
+    for (auto* unit : units) unit->toggle(args...);
+  }
+  template <typename... Args>
+  void toggleButton(Args&&... args) {
+    for (auto* unit : units) unit->toggleButton(args...);
+  }
+  template <typename... Args>
+  void onButton(Args&&... args) {
+    for (auto* unit : units) unit->onButton(args...);
+  }
+  template <typename... Args>
+  void onControl(Args&&... args) {
+    for (auto* unit : units) unit->onControl(args...);
+  }
+  template <typename... Args>
+  void radio(Args&&... args) {
+    for (auto* unit : units) unit->radio(args...);
+  }
+  void knobDeadband(int index, int steps);
+  void clearKnob(int index);
+  void clearCallbacks();
+
+  // Pages of all the units, see ofxControllerBase::addPage().
+  int addPage(const std::string& pageName);
+  void editPage(int page);
+  void editPage(const std::string& pageName);
+  void setPage(int page);
+  void setPage(const std::string& pageName);
+
+  /**
+   * Pickup feedback on every ofxLaunchControlXL unit set up in DAW mode,
+   * see ofxLaunchControlXL::enablePickupFeedback(). Other units are skipped.
+   */
+  void enablePickupFeedback(bool showOnDisplay = false, float rateHz = 30.0f, int maxLedsPerUpdate = 8);
+  void disablePickupFeedback();
+
+  /**
+   * Anything else on every unit, e.g. [](ofxControllerBase& unit){ ... }.
+   */
+  template <typename F>
+  void each(F&& f) {
+    for (auto* unit : units) f(*unit);
+  }
+
+private:
+  std::vector<ofxControllerBase*> units;
+  ofxControllerBase::TakeoverMode takeover;
+  int tolerance;
+};
@@ -0,0 +1,196 @@
+#include "ofxControllerSharedState.h"
+
+#include "ofMain.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <new>
+
+namespace {
+constexpr uint32_t kMagic = 0x4c435853;  // "LCXS"
+constexpr uint32_t kVersion = 1;
+constexpr std::chrono::milliseconds kCheckInterval(100);
+}  // namespace
+
+struct ofxControllerSharedSegment {
+  std::atomic<uint32_t> magic;  // written last by the publisher
+  uint32_t version;
+  uint32_t stateSize;
+  ofxControllerSeqlock<ofxControllerState> state;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+              "shared memory state needs address free atomics");
+
+ofxControllerStatePublisher::ofxControllerStatePublisher()
+    : segment(nullptr) {
+}
+
+ofxControllerStatePublisher::~ofxControllerStatePublisher() {
+  close();
+}
+
+bool ofxControllerStatePublisher::setup(const std::string& name) {
+#ifdef _WIN32
+  ofLogError("ofxControllerStatePublisher") << "shared memory publishing is not supported on Windows";
+  return false;
+#else
+  close();
+
+  // other users only read it
+  int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+  if (fd < 0) {
+    ofLogError("ofxControllerStatePublisher") << "shm_open failed for " << name;
+    return false;
+  }
+  if (ftruncate(fd, sizeof(ofxControllerSharedSegment)) != 0) {
+    ofLogError("ofxControllerStatePublisher") << "ftruncate failed for " << name;
+    ::close(fd);
+    return false;
+  }
+  void* memory = mmap(nullptr, sizeof(ofxControllerSharedSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (memory == MAP_FAILED) {
+    ofLogError("ofxControllerStatePublisher") << "mmap failed for " << name;
+    return false;
+  }
+
+  segment = new (memory) ofxControllerSharedSegment();
+  segment->version = kVersion;
+  segment->stateSize = sizeof(ofxControllerState);
+  segment->magic.store(kMagic, std::memory_order_release);
+  this->name = name;
+
+  ofLogNotice("ofxControllerStatePublisher") << "publishing controller state to " << name;
+  return true;
+#endif
+}
+
+void ofxControllerStatePublisher::close() {
+#ifndef _WIN32
+  if (!segment) {
+    return;
+  }
+  segment->magic.store(0, std::memory_order_release);
+  munmap(segment, sizeof(ofxControllerSharedSegment));
+  shm_unlink(name.c_str());
+  segment = nullptr;
+#endif
+}
+
+void ofxControllerStatePublisher::publish(const ofxControllerState& state) {
+  if (segment) {
+    segment->state.write(state);
+  }
+}
+
+ofxControllerStateReader::ofxControllerStateReader()
+    : segment(nullptr), inode(0) {
+}
+
+ofxControllerStateReader::~ofxControllerStateReader() {
+  close();
+}
+
+bool ofxControllerStateReader::setup(const std::string& name) {
+  close();
+  this->name = name;
+  nextCheck = std::chrono::steady_clock::now() + kCheckInterval;
+  return map();
+}
+
+bool ofxControllerStateReader::map() {
+#ifdef _WIN32
+  return false;
+#else
+  unmap();
+
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(ofxControllerSharedSegment)) {
+    ::close(fd);
+    return false;
+  }
+  void* memory = mmap(nullptr, sizeof(ofxControllerSharedSegment), PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (memory == MAP_FAILED) {
+    return false;
+  }
+
+  const auto* mapped = static_cast<const ofxControllerSharedSegment*>(memory);
+  if (mapped->magic.load(std::memory_order_acquire) != kMagic || mapped->version != kVersion ||
+      mapped->stateSize != sizeof(ofxControllerState)) {
+    ofLogWarning("ofxControllerStateReader") << "incompatible or inactive segment " << name;
+    munmap(memory, sizeof(ofxControllerSharedSegment));
+    return false;
+  }
+
+  segment = mapped;
+  inode = info.st_ino;
+  return true;
+#endif
+}
+
+bool ofxControllerStateReader::replaced() const {
+#ifdef _WIN32
+  return false;
+#else
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    return false;  // not published again yet
+  }
+  struct stat info;
+  bool other = fstat(fd, &info) == 0 && uint64_t(info.st_ino) != inode;
+  ::close(fd);
+  return other;
+#endif
+}
+
+void ofxControllerStateReader::unmap() {
+#ifndef _WIN32
+  if (segment) {
+    munmap(const_cast<ofxControllerSharedSegment*>(segment), sizeof(ofxControllerSharedSegment));
+    segment = nullptr;
+  }
+#endif
+}
+
+void ofxControllerStateReader::close() {
+  unmap();
+  name.clear();
+}
+
+bool ofxControllerStateReader::read(ofxControllerState& state) {
+  if (name.empty()) {
+    return false;
+  }
+
+  // A restarted publisher creates a new segment: the old one reads 0 after a
+  // clean close, a crashed one keeps its magic but the name moved on.
+  bool valid = segment && segment->magic.load(std::memory_order_acquire) == kMagic;
+  auto now = std::chrono::steady_clock::now();
+  if (now >= nextCheck) {
+    nextCheck = now + kCheckInterval;
+    if (!valid || replaced()) {
+      valid = map() && segment->magic.load(std::memory_order_acquire) == kMagic;
+    }
+  }
+  if (!valid) {
+    return false;
+  }
+  // A publisher that died mid-write leaves the sequence odd forever, give up
+  // and look for a new segment on the next call.
+  if (!segment->state.tryRead(state)) {
+    nextCheck = now;
+    return false;
+  }
+  return state.sequence != 0;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "ofxControllerState.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+struct ofxControllerSharedSegment;
+
+/**
+ * Mirrors ofxControllerState snapshots into a POSIX shared memory segment,
+ * so other processes on the same machine can read the controller without
+ * owning the MIDI port.
+ *
+ * The segment holds a small header and an ofxControllerSeqlock, readers
+ * never block the publisher and never take locks.
+ * Not available on Windows, setup() returns false there.
+ */
+class ofxControllerStatePublisher {
+public:
+  ofxControllerStatePublisher();
+  ~ofxControllerStatePublisher();
+
+  /**
+   * Create (or reuse) the segment, e.g. "/launchcontrol".
+   */
+  bool setup(const std::string& name);
+
+  /**
+   * Unmap and remove the segment.
+   */
+  void close();
+
+  bool isOpen() const { return segment != nullptr; }
+
+  void publish(const ofxControllerState& state);
+
+private:
+  std::string name;
+  ofxControllerSharedSegment* segment;
+};
+
+/**
+ * Reader side of ofxControllerStatePublisher, usable from any process.
+ */
+class ofxControllerStateReader {
+public:
+  ofxControllerStateReader();
+  ~ofxControllerStateReader();
+
+  /**
+   * Map an existing segment read-only. If the publisher is not running yet
+   * it returns false, read() keeps trying to map the segment.
+   */
+  bool setup(const std::string& name);
+  void close();
+
+  bool isOpen() const { return segment != nullptr; }
+
+  /**
+   * Copy the latest published state. When the publisher was restarted the
+   * segment is mapped again, checked at most every 100 ms.
+   * @return false if not connected, nothing was published yet or the
+   *         publisher is stuck mid-write
+   */
+  bool read(ofxControllerState& state);
+
+private:
+  bool map();              // the segment of `name`, false if not published
+  bool replaced() const;   // `name` refers to another segment than the mapped one
+  void unmap();
+
+  std::string name;
+  const ofxControllerSharedSegment* segment;
+  uint64_t inode;
+  std::chrono::steady_clock::time_point nextCheck;
+};
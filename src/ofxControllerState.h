@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * Plain snapshot of all control states of a controller.
+ *
+ * Trivially copyable and contiguous, so it can be copied in one go, e.g. into
+ * a GPU uniform buffer. Published by ofxControllerBase after each drain of
+ * its message buffer, see ofxControllerBase::getState().
+ */
+struct ofxControllerState {
+  static constexpr int maxKnobs = 32;
+  static constexpr int maxButtons = 16;
+  static constexpr int maxRadios = 16;
+
+  uint64_t sequence;                 // incremented on every publish, 0 = never published
+  uint64_t time;                     // publish time, ofxControllerClock::now()
+  uint64_t knobTimes[maxKnobs];      // last arrival time per knob / fader
+  uint64_t buttonTimes[maxButtons];  // last arrival time per button
+  float values[maxKnobs];            // scaled value of the first binding, or raw / 127 if unbound
+  int32_t radios[maxRadios];         // radio group values, in binding order
+  int32_t numRadios;
+  uint8_t knobs[maxKnobs];           // raw MIDI values 0-127
+  uint8_t buttons[maxButtons];       // 1 while the button is held down
+};
+
+/**
+ * Single writer, multiple reader sequence lock.
+ *
+ * The writer never blocks, readers retry while a write is in progress. The
+ * payload is copied through relaxed atomic words, so readers never race on
+ * plain memory even when they observe a torn copy that they then discard.
+ */
+template <typename T>
+class ofxControllerSeqlock {
+  static_assert(std::is_trivially_copyable<T>::value, "seqlock payload must be trivially copyable");
+
+public:
+  ofxControllerSeqlock() : seq(0) {
+    for (auto& w : words) {
+      w.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * Publish a new value. Must only be called from one thread at a time.
+   */
+  void write(const T& value) {
+    uint64_t buffer[numWords] = {};
+    std::memcpy(buffer, &value, sizeof(T));
+
+    uint32_t s = seq.load(std::memory_order_relaxed);
+    seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < numWords; ++i) {
+      words[i].store(buffer[i], std::memory_order_relaxed);
+    }
+    seq.store(s + 2, std::memory_order_release);
+  }
+
+  /**
+   * Read a consistent copy, safe from any thread.
+   */
+  void read(T& value) const {
+    while (!tryRead(value, 1)) {
+    }
+  }
+
+  /**
+   * Read a consistent copy, giving up after `attempts` torn reads. Use it
+   * when the writer may die mid-write, e.g. in another process.
+   * @return false if no consistent copy was read, `value` is left untouched
+   */
+  bool tryRead(T& value, int attempts = 16) const {
+    uint64_t buffer[numWords];
+    for (int attempt = 0; attempt < attempts; ++attempt) {
+      uint32_t before = seq.load(std::memory_order_acquire);
+      if (before & 1) {
+        continue;
+      }
+      for (size_t i = 0; i < numWords; ++i) {
+        buffer[i] = words[i].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (seq.load(std::memory_order_relaxed) == before) {
+        std::memcpy(&value, buffer, sizeof(T));
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Number of completed writes.
+   */
+  uint32_t version() const { return seq.load(std::memory_order_acquire) / 2; }
+
+private:
+  static constexpr size_t numWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+  std::atomic<uint32_t> seq;
+  std::atomic<uint64_t> words[numWords];
+};
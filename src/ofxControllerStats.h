@@ -0,0 +1,47 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * Update costs and input latency of a controller, or of all the controllers
+ * of an ofxControllerManager. Times are in nanoseconds, latency is measured
+ * from the arrival of a message to its dispatch in update().
+ */
+struct ofxControllerStats {
+  uint64_t updates = 0;
+  uint64_t messages = 0;        // dispatched
+  uint64_t ledMessages = 0;     // sent
+  uint64_t ledsCoalesced = 0;   // replaced by a later value in the same update
+  uint64_t latencyTotal = 0;
+  uint64_t latencyMax = 0;
+  uint64_t updateTimeTotal = 0;
+  uint64_t updateTimeMax = 0;
+
+  double getMeanLatency() const { return messages > 0 ? double(latencyTotal) / messages : 0.0; }
+  double getMeanUpdateTime() const { return updates > 0 ? double(updateTimeTotal) / updates : 0.0; }
+
+  void addLatency(uint64_t latency) {
+    ++messages;
+    latencyTotal += latency;
+    latencyMax = std::max(latencyMax, latency);
+  }
+
+  void addUpdate(uint64_t time) {
+    ++updates;
+    updateTimeTotal += time;
+    updateTimeMax = std::max(updateTimeMax, time);
+  }
+
+  /**
+   * Combines the message and led counts of another controller, update times
+   * are left alone: controllers sharing one update have a combined one.
+   */
+  void merge(const ofxControllerStats& other) {
+    messages += other.messages;
+    ledMessages += other.ledMessages;
+    ledsCoalesced += other.ledsCoalesced;
+    latencyTotal += other.latencyTotal;
+    latencyMax = std::max(latencyMax, other.latencyMax);
+  }
+};
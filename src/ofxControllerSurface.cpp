@@ -0,0 +1,184 @@
+#include "ofxControllerSurface.h"
+
+void ofxControllerSurface::add(ofxControllerBase& unit) {
+  addKnobs(unit, 0, int(unit.knobsCC.size()));
+  addButtons(unit, 0, int(unit.buttonsNote.size()));
+}
+
+ofxControllerSurface::Unit& ofxControllerSurface::unitFor(ofxControllerBase& unit) {
+  for (auto& u : reverse) {
+    if (u.controller == &unit) {
+      return u;
+    }
+  }
+  units.push_back(&unit);
+  reverse.push_back({&unit, std::vector<int>(unit.knobsCC.size(), -1), std::vector<int>(unit.buttonsNote.size(), -1)});
+  return reverse.back();
+}
+
+const ofxControllerSurface::Unit* ofxControllerSurface::findUnit(const ofxControllerBase& unit) const {
+  for (auto& u : reverse) {
+    if (u.controller == &unit) {
+      return &u;
+    }
+  }
+  return nullptr;
+}
+
+void ofxControllerSurface::addKnobs(ofxControllerBase& unit, int first, int count) {
+  if (first < 0 || count < 0 || first + count > int(unit.knobsCC.size())) {
+    ofLogError() << "ofxLaunchControls: wrong indices for addKnobs() function, ignored";
+    return;
+  }
+  Unit& u = unitFor(unit);
+  for (int i = first; i < first + count; ++i) {
+    if (u.knobIndex[i] < 0) {
+      u.knobIndex[i] = int(knobs.size());
+      knobs.push_back({&unit, i});
+    }
+  }
+}
+
+void ofxControllerSurface::addButtons(ofxControllerBase& unit, int first, int count) {
+  if (first < 0 || count < 0 || first + count > int(unit.buttonsNote.size())) {
+    ofLogError() << "ofxLaunchControls: wrong indices for addButtons() function, ignored";
+    return;
+  }
+  Unit& u = unitFor(unit);
+  for (int i = first; i < first + count; ++i) {
+    if (u.buttonIndex[i] < 0) {
+      u.buttonIndex[i] = int(buttons.size());
+      buttons.push_back({&unit, i});
+    }
+  }
+}
+
+void ofxControllerSurface::clear() {
+  knobs.clear();
+  buttons.clear();
+  units.clear();
+  reverse.clear();
+}
+
+ofxControllerSurface::Slot ofxControllerSurface::getKnob(int index) const {
+  return index >= 0 && index < int(knobs.size()) ? knobs[index] : Slot{nullptr, -1};
+}
+
+ofxControllerSurface::Slot ofxControllerSurface::getButton(int index) const {
+  return index >= 0 && index < int(buttons.size()) ? buttons[index] : Slot{nullptr, -1};
+}
+
+ofxControllerSurface::Slot ofxControllerSurface::knobSlot(int index, const char* function) const {
+  Slot slot = getKnob(index);
+  if (!slot.unit) {
+    ofLogError() << "ofxLaunchControls: wrong indices for " << function << "() function, binding ignored";
+  }
+  return slot;
+}
+
+ofxControllerSurface::Slot ofxControllerSurface::buttonSlot(int index, const char* function) const {
+  Slot slot = getButton(index);
+  if (!slot.unit) {
+    ofLogError() << "ofxLaunchControls: wrong indices for " << function << "() function, binding ignored";
+  }
+  return slot;
+}
+
+int ofxControllerSurface::getKnobIndex(const ofxControllerBase& unit, int unitIndex) const {
+  const Unit* u = findUnit(unit);
+  return u && unitIndex >= 0 && unitIndex < int(u->knobIndex.size()) ? u->knobIndex[unitIndex] : -1;
+}
+
+int ofxControllerSurface::getButtonIndex(const ofxControllerBase& unit, int unitIndex) const {
+  const Unit* u = findUnit(unit);
+  return u && unitIndex >= 0 && unitIndex < int(u->buttonIndex.size()) ? u->buttonIndex[unitIndex] : -1;
+}
+
+int ofxControllerSurface::getKnobIndexForCC(const ofxControllerBase& unit, int cc) const {
+  if (cc < 0 || cc >= int(unit.knobIndexForCC.size())) {
+    return -1;
+  }
+  return getKnobIndex(unit, unit.knobIndexForCC[cc]);
+}
+
+int ofxControllerSurface::getButtonIndexForNote(const ofxControllerBase& unit, int note) const {
+  if (note < 0 || note >= int(unit.buttonIndexForNote.size())) {
+    return -1;
+  }
+  return getButtonIndex(unit, unit.buttonIndexForNote[note]);
+}
+
+void ofxControllerSurface::knobDeadband(int index, int steps) {
+  Slot slot = knobSlot(index, "knobDeadband");
+  if (slot.unit) slot.unit->knobDeadband(slot.index, steps);
+}
+
+void ofxControllerSurface::clearKnob(int index) {
+  Slot slot = knobSlot(index, "clearKnob");
+  if (slot.unit) slot.unit->clearKnob(slot.index);
+}
+
+void ofxControllerSurface::clearKnobImmediate(int index) {
+  Slot slot = knobSlot(index, "clearKnobImmediate");
+  if (slot.unit) slot.unit->clearKnobImmediate(slot.index);
+}
+
+uint64_t ofxControllerSurface::getKnobTime(int index) const {
+  Slot slot = getKnob(index);
+  return slot.unit ? slot.unit->getKnobTime(slot.index) : 0;
+}
+
+uint64_t ofxControllerSurface::getButtonTime(int index) const {
+  Slot slot = getButton(index);
+  return slot.unit ? slot.unit->getButtonTime(slot.index) : 0;
+}
+
+void ofxControllerSurface::radio(int indexMin, int indexMax, ofParameter<int>& param, int color, int offColor) {
+  Slot first = getButton(indexMin);
+  bool consecutive = first.unit && indexMin <= indexMax && indexMax < getNumButtons();
+  for (int i = indexMin + 1; consecutive && i <= indexMax; ++i) {
+    Slot slot = getButton(i);
+    consecutive = slot.unit == first.unit && slot.index == first.index + (i - indexMin);
+  }
+  if (consecutive) {
+    first.unit->radio(first.index, first.index + (indexMax - indexMin), param, color, offColor);
+  } else {
+    ofLogError() << "ofxLaunchControls: wrong indices for radio() function, binding ignored";
+  }
+}
+
+int ofxControllerSurface::addPage(const std::string& pageName) {
+  int page = -1;
+  for (auto* unit : units) {
+    int p = unit->addPage(pageName);
+    if (page >= 0 && p != page) {
+      ofLogWarning() << "ofxLaunchControls: page \"" << pageName << "\" has different indices on the units, use its name";
+    }
+    page = p;
+  }
+  return page;
+}
+
+void ofxControllerSurface::editPage(int page) {
+  for (auto* unit : units) {
+    unit->editPage(page);
+  }
+}
+
+void ofxControllerSurface::editPage(const std::string& pageName) {
+  for (auto* unit : units) {
+    unit->editPage(pageName);
+  }
+}
+
+void ofxControllerSurface::setPage(int page) {
+  for (auto* unit : units) {
+    unit->setPage(page);
+  }
+}
+
+void ofxControllerSurface::setPage(const std::string& pageName) {
+  for (auto* unit : units) {
+    unit->setPage(pageName);
+  }
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ofxControllerBase.h"
+
+/**
+ * One logical index space over the controls of several controllers.
+ *
+ * Ranges of knobs and buttons are appended in the order they are added, so
+ * with two XLs the faders can be logical knobs 0-15:
+ *
+ *     ofxControllerSurface faders;
+ *     faders.addKnobs(xlA, 24, 8);  // faders of the first unit are 0-7
+ *     faders.addKnobs(xlB, 24, 8);  // of the second one 8-15
+ *     for (int i = 0; i < 16; ++i) faders.knob(i, levels[i]);
+ *
+ * Binding functions take logical indices and bind on the unit that owns the
+ * control, so every unit dispatches its own messages and sends its leds on
+ * its own port. A unit can be part of several surfaces, e.g. one for the
+ * faders and one for the encoders. Units must outlive the surface.
+ */
+class ofxControllerSurface {
+public:
+  struct Slot {
+    ofxControllerBase* unit;  // nullptr if the logical index is out of range
+    int index;                // knob or button index on the unit
+  };
+
+  /**
+   * Appends all the knobs and buttons of a unit.
+   */
+  void add(ofxControllerBase& unit);
+
+  /**
+   * Appends `count` knobs / buttons of a unit, starting from its index `first`.
+   */
+  void addKnobs(ofxControllerBase& unit, int first, int count);
+  void addButtons(ofxControllerBase& unit, int first, int count);
+
+  void clear();
+
+  int getNumKnobs() const { return int(knobs.size()); }
+  int getNumButtons() const { return int(buttons.size()); }
+  const std::vector<ofxControllerBase*>& getUnits() const { return units; }
+
+  Slot getKnob(int index) const;
+  Slot getButton(int index) const;
+
+  /**
+   * Logical index of a control of a unit, -1 if it's not on the surface.
+   * Table lookups, e.g. to translate the events of a unit's subscribe() queue.
+   * The cc and note versions need the unit to be set up.
+   */
+  int getKnobIndex(const ofxControllerBase& unit, int unitIndex) const;
+  int getButtonIndex(const ofxControllerBase& unit, int unitIndex) const;
+  int getKnobIndexForCC(const ofxControllerBase& unit, int cc) const;
+  int getButtonIndexForNote(const ofxControllerBase& unit, int note) const;
+
+  // Knob bindings, same arguments as the ofxControllerBase functions.
+  template <typename... Args>
+  void knob(int index, Args&&... args) {
+    Slot slot = knobSlot(index, "knob");
+    if (slot.unit) slot.unit->knob(slot.index, std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  void knobPickup(int index, Args&&... args) {
+    Slot slot = knobSlot(index, "knobPickup");
+    if (slot.unit) slot.unit->knobPickup(slot.index, std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  void knobTakeover(int index, Args&&... args) {
+    Slot slot = knobSlot(index, "knobTakeover");
+    if (slot.unit) slot.unit->knobTakeover(slot.index, std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  void knobHiRes(int index, Args&&... args) {
+    Slot slot = knobSlot(index, "knobHiRes");
+    if (slot.unit) slot.unit->knobHiRes(slot.index, std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  void encoder(int index, Args&&... args) {
+    Slot slot = knobSlot(index, "encoder");
+    if (slot.unit) slot.unit->encoder(slot.index, std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  void knobImmediate(int index, Args&&... args) {
+    Slot slot = knobSlot(index, "knobImmediate");
+    if (slot.unit) slot.unit->knobImmediate(slot.index, std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  void knobTap(int index, Args&&... args) {
+    Slot slot = knobSlot(index, "knobTap");
+    if (slot.unit) slot.unit->knobTap(slot.index, std::forward<Args>(args)...);
+  }
+  void knobDeadband(int index, int steps);
+  void clearKnob(int index);
+  void clearKnobImmediate(int index);
+  uint64_t getKnobTime(int index) const;
+
+  // Button bindings, same arguments as the ofxControllerBase functions.
+  template <typename... Args>
+  void button(int index, Args&&... args) {
+    Slot slot = buttonSlot(index, "button");
+    if (slot.unit) slot.unit->button(slot.index, std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  void momentary(int index, Args&&... args) {
+    Slot slot = buttonSlot(index, "momentary");
+    if (slot.unit) slot.unit->momentary(slot.index, std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  void toggle(int index, Args&&... args) {
+    Slot slot = buttonSlot(index, "toggle");
+    if (slot.unit) slot.unit->toggle(slot.index, std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  void onButton(int index, Args&&... args) {
+    Slot slot = buttonSlot(index, "onButton");
+    if (slot.unit) slot.unit->onButton(slot.index, std::forward<Args>(args)...);
+  }
+  uint64_t getButtonTime(int index) const;
+
+  /**
+   * Every logical button from indexMin to indexMax must be on the same unit,
+   * with consecutive indices there.
+   */
+  void radio(int indexMin, int indexMax, ofParameter<int>& param, int color = ofxLCLeds::Red, int offColor = ofxLCLeds::Off);
+
+  // Pages of all the units, see ofxControllerBase::addPage().
+  int addPage(const std::string& pageName);
+  void editPage(int page);
+  void editPage(const std::string& pageName);
+  void setPage(int page);
+  void setPage(const std::string& pageName);
+
+private:
+  struct Unit {
+    ofxControllerBase* controller;
+    std::vector<int> knobIndex;    // per unit knob, -1 if not on the surface
+    std::vector<int> buttonIndex;  // per unit button
+  };
+
+  Unit& unitFor(ofxControllerBase& unit);
+  const Unit* findUnit(const ofxControllerBase& unit) const;
+  Slot knobSlot(int index, const char* function) const;
+  Slot buttonSlot(int index, const char* function) const;
+
+  std::vector<Slot> knobs;    // by logical index
+  std::vector<Slot> buttons;
+  std::vector<ofxControllerBase*> units;
+  std::vector<Unit> reverse;  // parallel to units
+};
@@ -0,0 +1,99 @@
+#include "ofxControllerTimerWheel.h"
+
+ofxControllerTimerWheel::ofxControllerTimerWheel()
+    : tick(1000000), currentTick(0), numPending(0) {}
+
+void ofxControllerTimerWheel::setup(size_t numTimers, uint64_t now, uint64_t tickDuration) {
+  tick = tickDuration > 0 ? tickDuration : 1;
+  currentTick = now / tick;
+  nodes.assign(numTimers, {0, -1, -1, -1});
+  heads.assign(level0Size + level1Size, -1);
+  numPending = 0;
+}
+
+void ofxControllerTimerWheel::schedule(size_t id, uint64_t deadline) {
+  if (id >= nodes.size()) {
+    return;
+  }
+  if (nodes[id].slot >= 0) {
+    unlink(int(id));
+  } else {
+    ++numPending;
+  }
+  uint64_t ticks = deadline / tick;
+  nodes[id].deadline = ticks > currentTick ? ticks : currentTick + 1;
+  link(int(id));
+}
+
+void ofxControllerTimerWheel::cancel(size_t id) {
+  if (id < nodes.size() && nodes[id].slot >= 0) {
+    unlink(int(id));
+    nodes[id].slot = -1;
+    --numPending;
+  }
+}
+
+void ofxControllerTimerWheel::cancelAll() {
+  for (auto& node : nodes) {
+    node.slot = -1;
+  }
+  for (auto& head : heads) {
+    head = -1;
+  }
+  numPending = 0;
+}
+
+bool ofxControllerTimerWheel::isPending(size_t id) const {
+  return id < nodes.size() && nodes[id].slot >= 0;
+}
+
+void ofxControllerTimerWheel::link(int id) {
+  Node& node = nodes[id];
+  uint64_t delta = node.deadline - currentTick;
+  int slot;
+  if (delta < level0Size) {
+    slot = int(node.deadline & level0Mask);
+  } else {
+    uint64_t blocks = (node.deadline >> level0Bits) - (currentTick >> level0Bits);
+    uint64_t block = blocks < level1Size ? node.deadline >> level0Bits
+                                         : (currentTick >> level0Bits) + level1Size - 1;
+    slot = int(level0Size + (block & level1Mask));
+  }
+  node.slot = slot;
+  node.prev = -1;
+  node.next = heads[slot];
+  if (node.next >= 0) {
+    nodes[node.next].prev = id;
+  }
+  heads[slot] = id;
+}
+
+void ofxControllerTimerWheel::unlink(int id) {
+  Node& node = nodes[id];
+  if (node.prev >= 0) {
+    nodes[node.prev].next = node.next;
+  } else {
+    heads[node.slot] = node.next;
+  }
+  if (node.next >= 0) {
+    nodes[node.next].prev = node.prev;
+  }
+  node.prev = -1;
+  node.next = -1;
+}
+
+int ofxControllerTimerWheel::detachSlot(int slot) {
+  int id = heads[slot];
+  heads[slot] = -1;
+  return id;
+}
+
+void ofxControllerTimerWheel::cascade() {
+  int slot = int(level0Size + ((currentTick >> level0Bits) & level1Mask));
+  int id = detachSlot(slot);
+  while (id >= 0) {
+    int next = nodes[id].next;
+    link(id);
+    id = next;
+  }
+}
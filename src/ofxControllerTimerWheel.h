@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Two level hierarchical timer wheel with a fixed set of timers.
+ *
+ * Timers are identified by index (e.g. one per button) and each one is either
+ * idle or pending once, scheduling it again moves it. Scheduling, cancelling
+ * and expiring are O(1) and never allocate after setup(). advance() is driven
+ * by the owner's tick, ticks are 1 ms by default: the first level covers 256
+ * ticks, the second 64 * 256 ticks, later deadlines are parked in the last
+ * slot and rescheduled when it comes around.
+ *
+ * Not thread safe, use it from the thread that calls advance().
+ */
+class ofxControllerTimerWheel {
+public:
+  ofxControllerTimerWheel();
+
+  void setup(size_t numTimers, uint64_t now, uint64_t tickDuration = 1000000);
+
+  /**
+   * Deadline in the same unit as `now`, e.g. ofxControllerClock::now().
+   * Deadlines in the past expire on the next tick.
+   */
+  void schedule(size_t id, uint64_t deadline);
+  void cancel(size_t id);
+  void cancelAll();
+  bool isPending(size_t id) const;
+  size_t getNumPending() const { return numPending; }
+
+  /**
+   * Runs the ticks up to `now`, calling expired(id) for each expired timer.
+   * The callback may schedule the expired timer again, or schedule idle ones.
+   */
+  template <typename F>
+  void advance(uint64_t now, F&& expired) {
+    uint64_t target = now / tick;
+    if (numPending == 0) {
+      currentTick = std::max(currentTick, target);
+      return;
+    }
+    while (currentTick < target) {
+      ++currentTick;
+      if ((currentTick & level0Mask) == 0) {
+        cascade();
+      }
+      int id = detachSlot(int(currentTick & level0Mask));
+      while (id >= 0) {
+        int next = nodes[id].next;
+        if (nodes[id].deadline <= currentTick) {
+          nodes[id].slot = -1;
+          --numPending;
+          expired(size_t(id));
+        } else {
+          link(id);
+        }
+        id = next;
+      }
+    }
+  }
+
+private:
+  static constexpr int level0Bits = 8;
+  static constexpr int level1Bits = 6;
+  static constexpr uint64_t level0Size = 1 << level0Bits;
+  static constexpr uint64_t level1Size = 1 << level1Bits;
+  static constexpr uint64_t level0Mask = level0Size - 1;
+  static constexpr uint64_t level1Mask = level1Size - 1;
+
+  struct Node {
+    uint64_t deadline;  // in ticks
+    int slot;           // -1 when not pending
+    int prev;
+    int next;
+  };
+
+  void link(int id);
+  void unlink(int id);
+  int detachSlot(int slot);  // returns the first node, the slot is emptied
+  void cascade();            // moves the next second level slot down
+
+  std::vector<Node> nodes;
+  std::vector<int> heads;  // level 0 slots, then level 1 slots
+  uint64_t tick;
+  uint64_t currentTick;
+  size_t numPending;
+};
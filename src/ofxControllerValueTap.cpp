@@ -0,0 +1,77 @@
+#include "ofxControllerValueTap.h"
+#include "ofxControllerClock.h"
+
+#include <cmath>
+
+ofxControllerValueTap::ofxControllerValueTap(float initial, Ramp ramp)
+    : target(initial), time(0), ramp(ramp), current(initial), end(initial), step(0.0f), multiply(false), hold(0), remaining(0) {
+}
+
+void ofxControllerValueTap::setRamp(Ramp ramp) {
+  this->ramp.store(ramp, std::memory_order_relaxed);
+}
+
+void ofxControllerValueTap::setValue(float value) {
+  target.store(value, std::memory_order_relaxed);
+}
+
+void ofxControllerValueTap::setValue(float value, uint64_t time) {
+  this->time.store(time, std::memory_order_relaxed);
+  target.store(value, std::memory_order_relaxed);
+}
+
+void ofxControllerValueTap::beginBlock(int numFrames) {
+  startRamp(numFrames, 0);
+}
+
+void ofxControllerValueTap::beginBlock(int numFrames, uint64_t blockStartTime, double sampleRate) {
+  uint64_t eventTime = time.load(std::memory_order_relaxed);
+  startRamp(numFrames, ofxControllerClock::sampleOffset(eventTime, blockStartTime, sampleRate, numFrames));
+}
+
+void ofxControllerValueTap::startRamp(int numFrames, int offset) {
+  // finish the previous ramp exactly, in case the block was cut short
+  current = end;
+  end = target.load(std::memory_order_relaxed);
+
+  if (numFrames <= 0 || end == current) {
+    current = end;
+    step = 0.0f;
+    multiply = false;
+    hold = 0;
+    remaining = 0;
+    return;
+  }
+
+  hold = offset;
+  numFrames -= offset;
+  remaining = numFrames;
+  multiply = ramp.load(std::memory_order_relaxed) == Exponential && current * end > 0.0f;
+  if (multiply) {
+    step = std::pow(end / current, 1.0f / numFrames);
+  } else {
+    step = (end - current) / numFrames;
+  }
+}
+
+float ofxControllerValueTap::next() {
+  if (hold > 0) {
+    --hold;
+  } else if (remaining > 0) {
+    --remaining;
+    if (remaining == 0) {
+      current = end;
+    } else if (multiply) {
+      current *= step;
+    } else {
+      current += step;
+    }
+  }
+  return current;
+}
+
+void ofxControllerValueTap::fill(float* out, int numFrames) {
+  for (int i = 0; i < numFrames; ++i) {
+    out[i] = next();
+  }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Lock-free value tap for reading controller values from an audio callback.
+ *
+ * The controller writes new target values from the MIDI thread (see
+ * ofxControllerBase::knobTap()), the audio thread reads them once per block
+ * and ramps from the previous value to the new one over the block, so there
+ * is no zipper noise and no ofParameter access from the audio thread.
+ *
+ * beginBlock() / next() / fill() must only be called from one (audio) thread.
+ */
+class ofxControllerValueTap {
+public:
+  enum Ramp {
+    Linear = 0,
+    Exponential = 1  // falls back to linear when crossing or touching zero
+  };
+
+  explicit ofxControllerValueTap(float initial = 0.0f, Ramp ramp = Linear);
+
+  void setRamp(Ramp ramp);
+
+  /**
+   * Set a new target value, safe from any thread.
+   */
+  void setValue(float value);
+
+  /**
+   * Set a new target value with its event time (ofxControllerClock::now()).
+   */
+  void setValue(float value, uint64_t time);
+
+  /**
+   * The target and time slots written by the controller.
+   */
+  std::atomic<float>& getTarget() { return target; }
+  std::atomic<uint64_t>& getTime() { return time; }
+  float getTargetValue() const { return target.load(std::memory_order_relaxed); }
+
+  /**
+   * Latch the current target and prepare a ramp over numFrames samples.
+   * Call once at the start of every audio block.
+   */
+  void beginBlock(int numFrames);
+
+  /**
+   * Same as above, but the ramp starts at the sample offset of the last
+   * event time inside the block (see ofxControllerClock::sampleOffset()),
+   * holding the previous value until then.
+   */
+  void beginBlock(int numFrames, uint64_t blockStartTime, double sampleRate);
+
+  /**
+   * Next per-sample value of the current ramp.
+   */
+  float next();
+
+  /**
+   * Write the whole ramp of the current block into out[0..numFrames).
+   */
+  void fill(float* out, int numFrames);
+
+  /**
+   * Last value produced on the audio thread.
+   */
+  float getValue() const { return current; }
+
+private:
+  void startRamp(int numFrames, int offset);
+
+  std::atomic<float> target;
+  std::atomic<uint64_t> time;
+  std::atomic<int> ramp;
+
+  // audio thread state
+  float current;
+  float end;
+  float step;
+  bool multiply;
+  int hold;
+  int remaining;
+};
@@ -5,16 +5,16 @@
 ofxLaunchControl::ofxLaunchControl(){
 	name = "Launch Control";
 
-    buttons.resize(8);
-    buttons[0].controlNum = 9;
-    buttons[1].controlNum = 10;
-    buttons[2].controlNum = 11;
-    buttons[3].controlNum = 12;
-
-    buttons[4].controlNum = 25;
-    buttons[5].controlNum = 26;
-    buttons[6].controlNum = 27;
-    buttons[7].controlNum = 28;
+    buttonsNote.resize(8);
+    buttonsNote[0] = 9;
+    buttonsNote[1] = 10;
+    buttonsNote[2] = 11;
+    buttonsNote[3] = 12;
+
+    buttonsNote[4] = 25;
+    buttonsNote[5] = 26;
+    buttonsNote[6] = 27;
+    buttonsNote[7] = 28;
 
     knobsCC.resize(16);
     knobsCC[0]  = 21;
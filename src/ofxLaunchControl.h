@@ -7,4 +7,5 @@ class ofxLaunchControl : public ofxControllerBase {
 public:
 	ofxLaunchControl();
 	void setup( int id=-1, int channel=9 );
+	using ofxControllerBase::setup; // by port name, also while unplugged
 };
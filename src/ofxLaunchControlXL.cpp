@@ -1,30 +1,35 @@
 #include "ofxLaunchControlXL.h"
 
+namespace {
+const int shiftCC = 63;
+const int shiftChannel = 7;
+}
+
 ofxLaunchControlXL::ofxLaunchControlXL(){
   
   name = "Launch Control XL";
   
-  buttons.resize(16);
+  buttonsNote.resize(16);
   
-  buttons[0].controlNum = 24;
-  buttons[1].controlNum = 25;
-  buttons[2].controlNum = 26;
-  buttons[3].controlNum = 27;
+  buttonsNote[0] = 24;
+  buttonsNote[1] = 25;
+  buttonsNote[2] = 26;
+  buttonsNote[3] = 27;
   
-  buttons[4].controlNum = 28;
-  buttons[5].controlNum = 29;
-  buttons[6].controlNum = 30;
-  buttons[7].controlNum = 31;
+  buttonsNote[4] = 28;
+  buttonsNote[5] = 29;
+  buttonsNote[6] = 30;
+  buttonsNote[7] = 31;
   
-  buttons[8].controlNum = 45;
-  buttons[9].controlNum = 46;
-  buttons[10].controlNum = 47;
-  buttons[11].controlNum = 48;
+  buttonsNote[8] = 45;
+  buttonsNote[9] = 46;
+  buttonsNote[10] = 47;
+  buttonsNote[11] = 48;
   
-  buttons[12].controlNum = 49;
-  buttons[13].controlNum = 50;
-  buttons[14].controlNum = 51;
-  buttons[15].controlNum = 52;
+  buttonsNote[12] = 49;
+  buttonsNote[13] = 50;
+  buttonsNote[14] = 51;
+  buttonsNote[15] = 52;
   
   
   knobsCC.resize(32);
@@ -67,6 +72,11 @@ ofxLaunchControlXL::ofxLaunchControlXL(){
   knobsCC[31] = 12;
 }
 
+ofxLaunchControlXL::~ofxLaunchControlXL(){
+  // the reconnect thread uses the DAW leds, stop it before they go
+  disableReconnect();
+}
+
 bool ofxLaunchControlXL::setup( int id, int channel ){
   const auto & ports = midiIn.getInPortList();
   string target = "LCXL3";
@@ -127,33 +137,33 @@ bool ofxLaunchControlXL::setupDawMode( int channel ){
   return true;
 }
 
-void ofxLaunchControlXL::fader( int index, ofParameter<float> & param, float min, float max ){
+void ofxLaunchControlXL::fader( int index, ofParameter<float> & param, float min, float max, const ofxControllerCurve & curve ){
   if(index>=0 && index<8 ){
-    knob( index+24, param, min, max );
+    knob( index+24, param, min, max, curve );
   }else{
     ofLogError()<<"ofxLaunchControls: wrong index in fader() function, binding ignored";
   }
 }
 
-void ofxLaunchControlXL::fader( int index, ofParameter<int> & param, int min, int max ){
+void ofxLaunchControlXL::fader( int index, ofParameter<int> & param, int min, int max, const ofxControllerCurve & curve ){
   if(index>=0 && index<8 ){
-    knob( index+24, param, min, max );
+    knob( index+24, param, min, max, curve );
   }else{
     ofLogError()<<"ofxLaunchControls: wrong index in fader() function, binding ignored";
   }
 }
 
-void ofxLaunchControlXL::fader( int index, ofParameter<float> & param ){
+void ofxLaunchControlXL::fader( int index, ofParameter<float> & param, const ofxControllerCurve & curve ){
   if(index>=0 && index<8 ){
-    knob( index+24, param );
+    knob( index+24, param, curve );
   }else{
     ofLogError()<<"ofxLaunchControls: wrong index in fader() function, binding ignored";
   }
 }
 
-void ofxLaunchControlXL::fader( int index, ofParameter<int> & param ){
+void ofxLaunchControlXL::fader( int index, ofParameter<int> & param, const ofxControllerCurve & curve ){
   if(index>=0 && index<8 ){
-    knob( index+24, param);
+    knob( index+24, param, curve );
   }else{
     ofLogError()<<"ofxLaunchControls: wrong index in fader() function, binding ignored";
   }
@@ -165,4 +175,148 @@ void ofxLaunchControlXL::clearFaders(){
   }
 }
 
+void ofxLaunchControlXL::shiftLayer( int page ){
+  if( !dawModeActive ){
+    ofLogWarning("ofxLaunchControlXL") << "Shift is only sent in DAW mode, see setupDawMode()";
+  }
+  modifierCC( shiftCC, page, shiftChannel );
+}
+
+void ofxLaunchControlXL::enablePickupFeedback( bool showOnDisplay, float rateHz, int maxLedsPerUpdate ){
+  auto ports = tryLockPorts();
+  if( !leds || !dawModeActive ){
+    ofLogWarning("ofxLaunchControlXL") << "pickup feedback needs setupDawMode()";
+    return;
+  }
+  pickupFeedback = true;
+  pickupDisplay = showOnDisplay;
+  feedbackInterval = rateHz > 0.0f ? uint64_t(1000.0f / rateHz) : 0;
+  maxFeedbackLeds = std::max(maxLedsPerUpdate, 1);
+  feedbackShadow.assign( knobsCC.size(), { -1, -1, -1 } );
+  feedbackText.clear();
+  lastFeedbackTime = ofxControllerClock::now();
+  // being reconnected otherwise, onReconnect() sets the display up
+  if( pickupDisplay && ports.owns_lock() && leds->isConnected() ){
+    display.setup( leds->getMidiOut() );
+  }
+}
+
+void ofxLaunchControlXL::disablePickupFeedback(){
+  auto ports = tryLockPorts();
+  if( pickupFeedback && leds && ports.owns_lock() ){
+    for( size_t i=0; i<feedbackShadow.size(); ++i ){
+      if( feedbackShadow[i].r > 0 || feedbackShadow[i].g > 0 || feedbackShadow[i].b > 0 ){
+        leds->setLED( knobsCC[i], ofxLaunchControlXL3Leds::Color::off() );
+      }
+    }
+  }
+  pickupFeedback = false;
+  pickupDisplay = false;
+  feedbackShadow.clear();
+}
+
+void ofxLaunchControlXL::onUpdate(){
+  auto ports = tryLockPorts();
+  if( pickupFeedback && ports.owns_lock() ){
+    updatePickupFeedback();
+  }
+}
+
+void ofxLaunchControlXL::onPageChanged( int page ){
+  auto ports = tryLockPorts();
+  if( !ports.owns_lock() || !leds || !leds->isConnected() ){
+    return;
+  }
+  display.setup( leds->getMidiOut() );
+  display.showTemporary( "page", getPageName( page ) );
+  feedbackText.clear();
+}
+
+void ofxLaunchControlXL::onDisconnect(){
+  if( !leds ){
+    return;
+  }
+  display.setup( nullptr );
+  leds->disconnect();
+}
+
+bool ofxLaunchControlXL::onReconnect(){
+  if( !dawModeActive || !leds ){
+    return true;
+  }
+  // the leds and the display come back from their shadows
+  if( !leds->reconnect( true ) ){
+    return false;
+  }
+  display.setup( leds->getMidiOut() );
+  display.resend();
+  return true;
+}
+
+void ofxLaunchControlXL::onReconnected(){
+  feedbackText.clear();
+  lastFeedback = 0;
+  onPageChanged( getPage() );
+}
+
+void ofxLaunchControlXL::updatePickupFeedback(){
+  if( !leds || !leds->isConnected() ){
+    return;
+  }
+  uint64_t now = ofGetElapsedTimeMillis();
+  if( now - lastFeedback < feedbackInterval ){
+    return;
+  }
+  lastFeedback = now;
+
+  uint64_t since = lastFeedbackTime;
+  lastFeedbackTime = ofxControllerClock::now();
 
+  int sent = 0;
+  int touched = -1;
+  uint64_t touchedTime = since;
+
+  for( size_t i=0; i<knobsCC.size() && i<feedbackShadow.size(); ++i ){
+    PickupStatus status = getPickupStatus( i );
+    auto & shadow = feedbackShadow[i];
+
+    ofxLaunchControlXL3Leds::Color color = ofxLaunchControlXL3Leds::Color::off();
+    if( status.armed ){
+      if( !status.known ){
+        color = ofxLaunchControlXL3Leds::Color::softWhite();
+      }else{
+        int level = 24 + int( 103.0f * std::min( std::abs(status.distance) / 64.0f, 1.0f ) );
+        color = status.distance > 0.0f ? ofxLaunchControlXL3Leds::Color{ 0, 0, level }
+                                       : ofxLaunchControlXL3Leds::Color{ level, 0, 0 };
+      }
+    }else if( shadow.r < 0 ){
+      continue; // never armed, leave the LED to the app
+    }
+
+    if( color.r != shadow.r || color.g != shadow.g || color.b != shadow.b ){
+      if( sent >= maxFeedbackLeds ){
+        continue; // rest on the next update
+      }
+      leds->setLED( knobsCC[i], color );
+      shadow = color;
+      ++sent;
+    }
+
+    uint64_t time = getKnobTime( i );
+    if( status.armed && status.known && time > touchedTime ){
+      touched = i;
+      touchedTime = time;
+    }
+  }
+
+  if( pickupDisplay && touched >= 0 ){
+    PickupStatus status = getPickupStatus( touched );
+    int steps = int( std::round( std::abs(status.distance) ) );
+    std::string text = ( status.distance > 0.0f ? "up " : "down " ) + ofToString( steps );
+    std::string name = getKnobName( touched );
+    if( text + name != feedbackText ){
+      display.showTemporary( name, text );
+      feedbackText = text + name;
+    }
+  }
+}
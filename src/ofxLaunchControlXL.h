@@ -4,16 +4,19 @@
 
 #include "ofxControllerBase.h"
 #include "ofxLaunchControlXL3Leds.h"
+#include "ofxLaunchControlXL3Display.h"
 
 class ofxLaunchControlXL : public ofxControllerBase {
 public:
   ofxLaunchControlXL();
+  ~ofxLaunchControlXL();
   
   /**
    * Setup the controller using Custom Mode (main MIDI port).
    * LED control is NOT available in this mode.
    */
   bool setup( int id=-1, int channel=9 );
+  using ofxControllerBase::setup; // by port name, also while unplugged
   
   /**
    * Setup the controller using DAW Mode (DAW MIDI port).
@@ -22,21 +25,46 @@ public:
    */
   bool setupDawMode( int channel=1 );
   
-  void fader( int index, ofParameter<float> & param, float min, float max );
-  void fader( int index, ofParameter<int> & param, int min, int max );
-  void fader( int index, ofParameter<float> & param );
-  void fader( int index, ofParameter<int> & param );
+  void fader( int index, ofParameter<float> & param, float min, float max, const ofxControllerCurve & curve = ofxControllerCurve() );
+  void fader( int index, ofParameter<int> & param, int min, int max, const ofxControllerCurve & curve = ofxControllerCurve() );
+  void fader( int index, ofParameter<float> & param, const ofxControllerCurve & curve = ofxControllerCurve() );
+  void fader( int index, ofParameter<int> & param, const ofxControllerCurve & curve = ofxControllerCurve() );
 
   void clearFaders();
 
+  /**
+   * Use the Shift button as modifier (DAW mode): while Shift is held all the
+   * controls dispatch the bindings of the given page, see addPage().
+   * Shift sends CC 63 on channel 7, whatever channel the controller uses.
+   */
+  void shiftLayer( int page );
+
   /**
    * Get the LED controller (only available if setupDawMode() was used).
+   * With enableReconnect() the reconnect thread reopens its port and sends
+   * the last colors again: only use it while holding tryLockPorts().
+   *
+   *     auto ports = xl.tryLockPorts();
+   *     if( ports.owns_lock() && xl.getLeds() ) xl.getLeds()->setLED( 13, color );
    */
   ofxLaunchControlXL3Leds* getLeds() { return leds.get(); }
 
+  /**
+   * Show soft takeover state of knobPickup() / knobTakeover() bindings (DAW mode only).
+   * Armed encoders and faders light up blue when they have to move up and red
+   * when they have to move down, brighter the further away they are; the LED
+   * turns off on pickup. With showOnDisplay the OLED also shows the distance of
+   * the last touched armed control. Only changed LEDs are sent, at most
+   * maxLedsPerUpdate messages every 1000 / rateHz milliseconds.
+   */
+  void enablePickupFeedback(bool showOnDisplay = false, float rateHz = 30.0f, int maxLedsPerUpdate = 8);
+  void disablePickupFeedback();
+
   /**
    * Add an external MIDI listener to receive raw MIDI messages.
    * This allows external code to handle button presses, etc.
+   * Listeners run on the MIDI thread, subscribe() delivers typed and
+   * filtered events to a queue instead.
    */
   void addMidiListener(ofxMidiListener* listener) { midiIn.addListener(listener); }
 
@@ -45,7 +73,40 @@ public:
    */
   void removeMidiListener(ofxMidiListener* listener) { midiIn.removeListener(listener); }
 
+protected:
+  void onUpdate() override;
+
+  /**
+   * Shows the name of the new page on the display (DAW mode only).
+   */
+  void onPageChanged( int page ) override;
+
+  /**
+   * Closes the DAW port, the leds and the display only record their shadows
+   * until the device comes back.
+   */
+  void onDisconnect() override;
+
+  /**
+   * Reopens the DAW port, enables DAW mode and resends the leds and display.
+   */
+  bool onReconnect() override;
+  void onReconnected() override;
+
 private:
+  void updatePickupFeedback();
+
   std::unique_ptr<ofxLaunchControlXL3Leds> leds;
   bool dawModeActive = false;
+
+  // pickup feedback, LED colors as last sent (r < 0 = never sent)
+  bool pickupFeedback = false;
+  bool pickupDisplay = false;
+  uint64_t feedbackInterval = 33;
+  uint64_t lastFeedback = 0;
+  uint64_t lastFeedbackTime = 0;
+  int maxFeedbackLeds = 8;
+  std::vector<ofxLaunchControlXL3Leds::Color> feedbackShadow;
+  std::string feedbackText;
+  ofxLaunchControlXL3Display display;
 };
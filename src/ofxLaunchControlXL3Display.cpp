@@ -1,5 +1,7 @@
 #include "ofxLaunchControlXL3Display.h"
 
+#include <algorithm>
+
 namespace {
 // SysEx message constants for Launch Control XL 3
 constexpr unsigned char kSysExStart = 0xF0;
@@ -53,6 +55,7 @@ void ofxLaunchControlXL3Display::setText(uint8_t target, uint8_t field, const st
 }
 
 void ofxLaunchControlXL3Display::setStationary(const std::string& line1, const std::string& line2) {
+  stationary = {line1, line2};
   // Configure 2-line arrangement
   configure(kTargetStationary, kArrangement2Line);
   // Set field 0 (Name/line1)
@@ -64,6 +67,7 @@ void ofxLaunchControlXL3Display::setStationary(const std::string& line1, const s
 }
 
 void ofxLaunchControlXL3Display::setStationary3Line(const std::string& title, const std::string& name, const std::string& value) {
+  stationary = {title, name, value};
   // Configure 3-line arrangement (Title + Name + Value)
   configure(kTargetStationary, kArrangement3Line);
   // Set field 0 (Title)
@@ -88,6 +92,7 @@ void ofxLaunchControlXL3Display::showTemporary(const std::string& name, const st
 }
 
 void ofxLaunchControlXL3Display::clearStationary() {
+  stationary.clear();
   configure(kTargetStationary, kArrangementCancel);
 }
 
@@ -100,4 +105,19 @@ void ofxLaunchControlXL3Display::cancelControlDisplay(uint8_t target) {
   // Using arrangement 4 (Name + Numeric Value) with bits 5-6 cleared
   // prevents the device from showing temporary overlays when controls are moved.
   configure(target, kArrangementNumeric);
+  if (std::find(cancelled.begin(), cancelled.end(), target) == cancelled.end()) {
+    cancelled.push_back(target);
+  }
+}
+
+void ofxLaunchControlXL3Display::resend() {
+  std::vector<std::string> lines = stationary;
+  if (lines.size() == 2) {
+    setStationary(lines[0], lines[1]);
+  } else if (lines.size() == 3) {
+    setStationary3Line(lines[0], lines[1], lines[2]);
+  }
+  for (uint8_t target : cancelled) {
+    configure(target, kArrangementNumeric);
+  }
 }
@@ -69,10 +69,20 @@ public:
    */
   void cancelControlDisplay(uint8_t target);
 
+  /**
+   * Sends the stationary content and the cancelled controls again, e.g. after
+   * the device was reconnected. Temporary overlays are not kept.
+   */
+  void resend();
+
 private:
   void configure(uint8_t target, uint8_t config);
   void setText(uint8_t target, uint8_t field, const std::string& text);
   void sendSysEx(const std::vector<unsigned char>& data);
 
   ofxMidiOut* midiOut = nullptr;
+
+  // shadow of the device state, for resend()
+  std::vector<std::string> stationary;  // 2 or 3 lines, empty if cleared
+  std::vector<uint8_t> cancelled;
 };
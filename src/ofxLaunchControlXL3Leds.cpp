@@ -28,6 +28,9 @@ const std::string kLCXL3ShortName = "lcxl3";
 
 ofxLaunchControlXL3Leds::ofxLaunchControlXL3Leds()
     : connected(false), dawModeEnabled(false) {
+  for (auto& color : shadow) {
+    color = {-1, -1, -1};
+  }
 }
 
 ofxLaunchControlXL3Leds::~ofxLaunchControlXL3Leds() {
@@ -119,10 +122,6 @@ void ofxLaunchControlXL3Leds::disableDawMode() {
 }
 
 void ofxLaunchControlXL3Leds::setLED(int controlIndex, int r, int g, int b) {
-  if (!connected) {
-    return;
-  }
-
   // Clamp to valid MIDI data range
   r = ofClamp(r, 0, 127);
   g = ofClamp(g, 0, 127);
@@ -135,6 +134,12 @@ void ofxLaunchControlXL3Leds::setLED(int controlIndex, int r, int g, int b) {
     return;
   }
 
+  // kept while disconnected too, resendLEDs() applies it
+  shadow[controlIndex - kFirstIndex] = {r, g, b};
+  if (!connected) {
+    return;
+  }
+
   std::vector<unsigned char> sysex;
   sysex.reserve(13);
   sysex.push_back(kSysExStart);
@@ -223,6 +228,31 @@ void ofxLaunchControlXL3Leds::setBottomButtonRowLEDs(const Color& color) {
   setBottomButtonRowLEDs(color.r, color.g, color.b);
 }
 
+void ofxLaunchControlXL3Leds::disconnect() {
+  // the device is gone, nothing to disable on the old port
+  midiOut.closePort();
+  connected = false;
+  dawModeEnabled = false;
+}
+
+bool ofxLaunchControlXL3Leds::reconnect(bool enableDaw) {
+  // the device may have come back without a disconnect() before
+  disconnect();
+  if (!setup(enableDaw)) {
+    return false;
+  }
+  resendLEDs();
+  return true;
+}
+
+void ofxLaunchControlXL3Leds::resendLEDs() {
+  for (int i = 0; i < kNumIndices; ++i) {
+    if (shadow[i].r >= 0) {
+      setLED(kFirstIndex + i, shadow[i]);
+    }
+  }
+}
+
 void ofxLaunchControlXL3Leds::clearAllLEDs() {
   // Clear all controls (indices 5-52)
   for (int i = 5; i <= 52; ++i) {
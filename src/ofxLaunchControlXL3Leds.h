@@ -144,6 +144,24 @@ public:
    */
   ofxMidiOut* getMidiOut() { return connected ? &midiOut : nullptr; }
 
+  /**
+   * Closes the port of a device that went away, without disabling DAW mode.
+   * The colors set meanwhile are kept and sent by reconnect().
+   */
+  void disconnect();
+
+  /**
+   * Closes the dead port, finds and opens the DAW port again and sends the
+   * last color of every led, e.g. after the device was unplugged. Blocks for
+   * about 100 ms, ofxControllerBase calls it on its reconnect thread.
+   */
+  bool reconnect(bool enableDaw = true);
+
+  /**
+   * Sends the last color set for every led again.
+   */
+  void resendLEDs();
+
 private:
   void enableDawMode();
   void disableDawMode();
@@ -151,4 +169,9 @@ private:
   ofxMidiOut midiOut;
   bool connected;
   bool dawModeEnabled;
+
+  // last color per control index 5-52, r < 0 if never set
+  static constexpr int kFirstIndex = 5;
+  static constexpr int kNumIndices = 48;
+  Color shadow[kNumIndices];
 };
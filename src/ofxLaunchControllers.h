@@ -2,6 +2,18 @@
 #pragma once
 
 #include "ofxLCLeds.h"
+#include "ofxControllerCallback.h"
+#include "ofxControllerClock.h"
+#include "ofxControllerCurve.h"
+#include "ofxControllerEvents.h"
+#include "ofxControllerManager.h"
+#include "ofxControllerMirror.h"
+#include "ofxControllerSharedState.h"
+#include "ofxControllerState.h"
+#include "ofxControllerStats.h"
+#include "ofxControllerSurface.h"
+#include "ofxControllerTimerWheel.h"
+#include "ofxControllerValueTap.h"
 #include "ofxLaunchControl.h"
 #include "ofxLaunchControlXL.h"
 #include "ofxLaunchControlXL3Display.h"